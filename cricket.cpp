@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "dimensions.h"
+#include "outcome.h"
+#include "parallel.h"
+#include "cricket.h"
+
+
+namespace Cricket
+{
+
+namespace
+{
+
+constexpr std::array<char,8>    policyMagic     {'C','R','I','C','K','E','T',0};
+constexpr std::uint32_t         policyVersion   {1};
+
+constexpr float                 aimStep         {4.0f};         // mm between candidate aim-points
+
+constexpr int                   hits{targets * closed};         // (target, marks) pairs
+
+
+struct PolicyHeader
+{
+    std::array<char,8>  magic;
+    std::uint32_t       version;
+    ScatterModel        model;
+    std::uint32_t       aims;
+    std::uint32_t       states;
+};
+
+
+using Probabilities = std::array<float, hits>;                  // target*closed + marks-1
+
+
+int hit(int bed)                                                // target*closed + marks-1,  or -1 for a bed that doesn't count
+{
+    if(bed < 0)
+    {
+        return -1;
+    }
+
+    if(bed == Bed::outerBull)
+    {
+        return (targets-1) * closed;
+    }
+
+    if(bed == Bed::bull)
+    {
+        return (targets-1) * closed + 1;
+    }
+
+    auto const score      = bed % 20 + 1;
+    auto const multiplier = bed / 20 + 1;
+
+    if(score < 15)
+    {
+        return -1;
+    }
+
+    return (score-15) * closed + multiplier-1;
+}
+
+
+Probabilities probabilities(ScoreField const &field, Scatter const &darts, float x, float y)
+{
+    std::array<std::uint32_t, hits>     counts{};
+
+    for(std::size_t i=0;i<darts.x.size();i++)
+    {
+        auto const h = hit(field.bed(x + darts.x[i], y + darts.y[i]));
+
+        if(h >= 0)
+        {
+            counts[h]++;
+        }
+    }
+
+    Probabilities   p{};
+
+    for(int h=0;h<hits;h++)
+    {
+        p[h] = static_cast<float>(counts[h]) / darts.x.size();
+    }
+
+    return p;
+}
+
+
+Marks marks(std::uint32_t state)
+{
+    Marks   result{};
+
+    for(int target=0;target<targets;target++)
+    {
+        result[target] = static_cast<std::uint8_t>(state & 3);
+        state >>= 2;
+    }
+
+    return result;
+}
+
+}
+
+
+
+Policy solve(ScoreField const &field, Darts::BankView const &normals, ScatterModel const &model)
+{
+    Policy      policy;
+
+    policy.scatterModel = model;
+
+    auto const  darts = scatter(normals, model);
+    auto const  limit = static_cast<float>(Board::Radius::board);
+
+    std::vector<Probabilities>  chances;
+
+    for(float y=-limit; y<=limit; y+=aimStep)
+    {
+        for(float x=-limit; x<=limit; x+=aimStep)
+        {
+            if(std::hypot(x,y) > limit)
+            {
+                continue;
+            }
+
+            auto const p = probabilities(field, darts, x, y);
+
+            if(std::any_of(p.begin(), p.end(), [](float f){ return f > 0; }))
+            {
+                policy.aimPoints.push_back({x,y});
+                chances.push_back(p);
+            }
+        }
+    }
+
+    if(policy.aimPoints.empty() || policy.aimPoints.size() > (std::numeric_limits<std::uint16_t>::max)())
+    {
+        throw std::runtime_error{"cricket : no usable aim-points"};
+    }
+
+
+/*
+
+    E(s) = min over aims of  (1 + sum p(s') E(s')) / q
+
+    where the sum is over the hits that add marks and q is their total
+    probability;  every other dart leaves the state unchanged.  A hit only adds
+    marks,  so processing states by decreasing total marks means every E(s') is
+    known,  and the states within a level are independent.
+
+*/
+
+    policy.choices.assign(states, 0);
+    policy.expected.assign(states, 0.0f);
+
+    std::array<std::vector<std::uint32_t>, targets*closed + 1>  levels;
+
+    for(std::uint32_t s=0;s<states;s++)
+    {
+        auto const m = marks(s);
+        int        total{};
+
+        for(auto mark : m)
+        {
+            total += mark;
+        }
+
+        levels[total].push_back(s);
+    }
+
+    for(int level=targets*closed-1; level >= 0; level--)
+    {
+        auto const         &todo = levels[level];
+        std::atomic<std::size_t>    next{};
+
+        auto worker = [&]
+        {
+            for(auto i = next++; i < todo.size(); i = next++)
+            {
+                auto const  s = todo[i];
+                auto const  m = marks(s);
+
+                std::array<int,   hits>     open;               // the hits that add marks
+                std::array<float, hits>     after;              // and E of the state they lead to
+                int                         count{};
+
+                for(int target=0;target<targets;target++)
+                {
+                    for(int add=1; add<=closed && m[target] < closed; add++)
+                    {
+                        auto const gained = (std::min)(closed, m[target]+add) - m[target];
+
+                        open [count] = target*closed + add-1;
+                        after[count] = policy.expected[s + (gained << (2*target))];
+                        count++;
+                    }
+                }
+
+                auto          best   = std::numeric_limits<float>::infinity();
+                std::uint16_t choice{};
+
+                for(std::size_t a=0;a<chances.size();a++)
+                {
+                    auto const &p = chances[a];
+                    float       q{};
+                    float       sum{1};
+
+                    for(int h=0;h<count;h++)
+                    {
+                        q   += p[open[h]];
+                        sum += p[open[h]] * after[h];
+                    }
+
+                    if(q > 0 && sum < best * q)
+                    {
+                        best   = sum / q;
+                        choice = static_cast<std::uint16_t>(a);
+                    }
+                }
+
+                policy.choices [s] = choice;
+                policy.expected[s] = best;
+            }
+        };
+
+        runOnAllCores(worker);
+    }
+
+    return policy;
+}
+
+
+
+Policy Policy::load(std::filesystem::path const &path)
+{
+    std::ifstream   file{path, std::ios::binary};
+    PolicyHeader    header{};
+
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        throw std::runtime_error{"cricket policy : truncated header"};
+    }
+
+    if(   header.magic   != policyMagic
+       || header.version != policyVersion
+       || header.states  != states
+       || header.aims    == 0)
+    {
+        throw std::runtime_error{"cricket policy : not a version 1 policy"};
+    }
+
+    Policy      policy;
+
+    policy.scatterModel = header.model;
+    policy.aimPoints.resize(header.aims);
+    policy.choices.resize(states);
+    policy.expected.resize(states);
+
+    if(   !file.read(reinterpret_cast<char*>(policy.aimPoints.data()), policy.aimPoints.size() * sizeof(policy.aimPoints[0]))
+       || !file.read(reinterpret_cast<char*>(policy.choices.data()),   policy.choices.size()   * sizeof(policy.choices[0]))
+       || !file.read(reinterpret_cast<char*>(policy.expected.data()),  policy.expected.size()  * sizeof(policy.expected[0])))
+    {
+        throw std::runtime_error{"cricket policy : truncated"};
+    }
+
+    if(std::any_of(policy.choices.begin(), policy.choices.end(), [&](auto choice){ return choice >= header.aims; }))
+    {
+        throw std::runtime_error{"cricket policy : aim out of range"};
+    }
+
+    return policy;
+}
+
+
+void Policy::save(std::filesystem::path const &path) const
+{
+    auto temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream   file{temporary, std::ios::binary};
+        PolicyHeader    header{policyMagic, policyVersion, scatterModel, static_cast<std::uint32_t>(aimPoints.size()), states};
+
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.write(reinterpret_cast<char const*>(aimPoints.data()), aimPoints.size() * sizeof(aimPoints[0]));
+        file.write(reinterpret_cast<char const*>(choices.data()),   choices.size()   * sizeof(choices[0]));
+        file.write(reinterpret_cast<char const*>(expected.data()),  expected.size()  * sizeof(expected[0]));
+
+        if(!file)
+        {
+            throw std::runtime_error{"cricket policy : write failed " + temporary.string()};
+        }
+    }
+
+    std::filesystem::rename(temporary, path);
+}
+
+}
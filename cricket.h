@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <filesystem>
+#include <vector>
+
+#include "sampleBank.h"
+#include "scoreField.h"
+#include "sweep.h"
+
+
+/*
+
+    Cricket,  played as a race to close 15-20 and the bull.
+
+    A single is 1 mark,  a double 2 and a treble 3;  the outer bull is 1 mark
+    on the bull and the bull 2.  A target is closed at 3 marks and marks beyond
+    that are wasted.  Points and the opponent aren't modelled,  so the policy
+    minimises the expected number of darts to close everything.
+
+    A state is the marks on each target,  7 targets of 0-3 marks,  so there are
+    4^7 of them.  The bed probabilities of every candidate aim-point are worked
+    out once from the score field and the scatter model,  after that solving
+    a state never throws a dart.
+
+*/
+
+
+namespace Cricket
+{
+
+constexpr int           targets{7};                 // 15,16,17,18,19,20,bull
+constexpr int           closed{3};
+constexpr std::uint32_t states{1u << (2*targets)};
+
+using Marks = std::array<std::uint8_t, targets>;
+
+
+constexpr std::uint32_t state(Marks const &marks)
+{
+    std::uint32_t   index{};
+
+    for(int target=targets-1; target >= 0; target--)
+    {
+        index = index * 4 + marks[target];
+    }
+
+    return index;
+}
+
+
+struct Aim
+{
+    float   x;                  // millimetres from the centre,  +y down
+    float   y;
+    float   darts;              // expected darts to close everything from here
+};
+
+
+
+class Policy
+{
+public:
+
+    Policy() = default;
+
+    static Policy   load(std::filesystem::path const &path);
+    void            save(std::filesystem::path const &path) const;      // written to a temporary, then renamed
+
+    ScatterModel const &model() const
+    {
+        return scatterModel;
+    }
+
+    Aim aim(Marks const &marks) const
+    {
+        auto const index = state(marks);
+        auto const point = aimPoints[choices[index]];
+
+        return { point[0], point[1], expected[index]};
+    }
+
+private:
+
+    friend Policy solve(ScoreField const &field, Darts::BankView const &normals, ScatterModel const &model);
+
+    ScatterModel                        scatterModel{};
+    std::vector<std::array<float,2>>    aimPoints;          // candidate aim-points
+    std::vector<std::uint16_t>          choices;            // by state,  into aimPoints
+    std::vector<float>                  expected;           // by state
+};
+
+
+Policy solve(ScoreField const &field, Darts::BankView const &normals, ScatterModel const &model);
+
+}
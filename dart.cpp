@@ -1,98 +1,156 @@
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <numbers>
-#include <random>
+#include <span>
+#include <thread>
+#include <vector>
 
 #include "print.h"
+#include "rng.h"
 #include "dimensions.h"
+#include "sampleBank.h"
 #include "window.h"
 
 
-auto genDartsSquare()
+namespace
 {
-    static std::mt19937                                     rng{ std::random_device{}()};
-    static std::uniform_real_distribution<Gdiplus::REAL>    square{-1.0,1.0};
 
-    std::array<Gdiplus::PointF, Darts::numDarts>            darts{};
+constexpr float twoPi{ static_cast<float>(2 * std::numbers::pi) };
 
-    for(auto &dart : darts)
+
+// Each model turns LANES uniforms per draw into LANES darts with a closed-form
+// transform (inverse-CDF for the radius, Box-Muller for normals) - no rejection loops.
+
+void genDartsUniformDisc(Rng::Xoshiro &rng, Rng::Xoshiro::Block &x, Rng::Xoshiro::Block &y)
+{
+    Rng::Xoshiro::Block u, v;
+
+    rng.uniform(u);
+    rng.uniform(v);
+
+    for(std::size_t i=0;i<Rng::lanes;i++)
     {
-        do
-        {
-            dart = { square(rng),square(rng)};
-        } while( std::hypot(dart.X, dart.Y) > 1);
-    }
+        auto const distance = std::sqrt(u[i]);
+        auto const theta    = twoPi * v[i];
 
-    return darts;
+        x[i] = distance * std::cos(theta);
+        y[i] = distance * std::sin(theta);
+    }
 }
 
 
-auto genDartsCircle()
+void genDartsCircle(Rng::Xoshiro &rng, Rng::Xoshiro::Block &x, Rng::Xoshiro::Block &y, float arc)
 {
-    static std::mt19937                                     rng{ std::random_device{}()};
-    static std::uniform_real_distribution<Gdiplus::REAL>    radius{0.0,1.0};
-    static std::uniform_int                                 angle{0, 360};
+    Rng::Xoshiro::Block u, v;
 
-    std::array<Gdiplus::PointF, Darts::numDarts>            darts{};
+    rng.uniform(u);
+    rng.uniform(v);
 
-    for(auto &dart : darts)
+    for(std::size_t i=0;i<Rng::lanes;i++)
     {
-        auto distance = radius(rng);
-        auto theta    = radians(angle(rng));
+        auto const theta = arc * v[i];
 
-        dart= {static_cast<Gdiplus::REAL>(distance*cos(theta)), 
-               static_cast<Gdiplus::REAL>(distance*sin(theta))};
+        x[i] = u[i] * std::cos(theta);
+        y[i] = u[i] * std::sin(theta);
     }
-
-    return darts;
 }
 
 
-
-auto genDartsLowerCircle()
+void genDartsRealistic(Rng::Xoshiro &rng, Rng::Xoshiro::Block &x, Rng::Xoshiro::Block &y)
 {
-    static std::mt19937                                     rng{ std::random_device{}()};
-    static std::uniform_real_distribution<Gdiplus::REAL>    radius{0.0,1.0};
-    static std::uniform_int                                 angle{0, 180};
+    constexpr float mean     { twoPi *  90 / 360 };      // mainly below the aim-point
+    constexpr float deviation{ twoPi *  60 / 360 };
+
+    Rng::Xoshiro::Block u, v, w;
 
-    std::array<Gdiplus::PointF, Darts::numDarts>            darts{};
+    rng.uniform(u);
+    rng.uniform(v);
+    rng.uniform(w);
 
-    for(auto &dart : darts)
+    for(std::size_t i=0;i<Rng::lanes;i++)
     {
-        auto distance = radius(rng);
-        auto theta    = radians(angle(rng));
+        auto const normal = std::sqrt(-2 * std::log(1 - v[i])) * std::cos(twoPi * w[i]);
+        auto const theta  = mean + deviation * normal;
 
-        dart= {static_cast<Gdiplus::REAL>(distance*cos(theta)), 
-               static_cast<Gdiplus::REAL>(distance*sin(theta))};
+        x[i] = u[i] * std::cos(theta);
+        y[i] = u[i] * std::sin(theta);
     }
-
-    return darts;
 }
 
 
-auto genDartsRealistic()
+void genDartsGaussian(Rng::Xoshiro &rng, Rng::Xoshiro::Block &x, Rng::Xoshiro::Block &y)
 {
-    static std::mt19937                                     rng{ std::random_device{}()};
-    static std::uniform_real_distribution<Gdiplus::REAL>    radius{0.0,1.0};
-    static std::normal_distribution<double>                 angle{90, 60};          // mainly below the aim-point
+    Rng::Xoshiro::Block u, v;
+
+    rng.uniform(u);
+    rng.uniform(v);
+
+    for(std::size_t i=0;i<Rng::lanes;i++)
+    {
+        auto const distance = Darts::gaussianSigma * std::sqrt(-2 * std::log(1 - u[i]));
+        auto const theta    = twoPi * v[i];
+
+        x[i] = distance * std::cos(theta);
+        y[i] = distance * std::sin(theta);
+    }
+}
 
-    std::array<Gdiplus::PointF, Darts::numDarts>            darts{};
 
-    for(auto &dart : darts)
+void genDartsChunk(Darts::Generator generator, std::uint64_t seed, std::uint64_t stream, std::span<float> x, std::span<float> y)
+{
+    Rng::Xoshiro            rng{seed, stream};
+    Rng::Xoshiro::Block     bx, by;
+
+    for(std::size_t i=0;i<x.size();i+=Rng::lanes)
     {
-        auto distance = radius(rng);
-        auto theta    = radians( angle(rng) );
+        switch(generator)
+        {
+        case Darts::Generator::uniformDisc:  genDartsUniformDisc(rng,bx,by);           break;
+        case Darts::Generator::circle:       genDartsCircle     (rng,bx,by,twoPi);     break;
+        case Darts::Generator::lowerCircle:  genDartsCircle     (rng,bx,by,twoPi/2);   break;
+        case Darts::Generator::realistic:    genDartsRealistic  (rng,bx,by);           break;
+        case Darts::Generator::gaussian:     genDartsGaussian   (rng,bx,by);           break;
+        }
+
+        auto const n = std::min<std::size_t>(Rng::lanes, x.size() - i);
 
-        dart= {static_cast<Gdiplus::REAL>(distance*cos(theta)), 
-               static_cast<Gdiplus::REAL>(distance*sin(theta))};
+        std::copy_n(bx.begin(), n, x.begin() + i);
+        std::copy_n(by.begin(), n, y.begin() + i);
     }
+}
 
-    return darts;
 }
 
 
 
-std::array<Gdiplus::PointF, Darts::numDarts> Darts::darts{genDartsRealistic()};           // -1.0 -> 1.0
+void Darts::generateDarts(Generator generator, std::uint64_t seed, std::span<float> x, std::span<float> y)
+{
+    auto const              chunks = (x.size() + generateChunk - 1) / generateChunk;
+    std::atomic<std::size_t> next{};
+
+    auto worker = [&]
+    {
+        for(auto chunk = next++; chunk < chunks; chunk = next++)
+        {
+            auto const first = chunk * generateChunk;
+            auto const count = std::min<std::size_t>(generateChunk, x.size() - first);
+
+            genDartsChunk(generator, seed, chunk, x.subspan(first,count), y.subspan(first,count));
+        }
+    };
+
+    auto const              threads = std::min<std::size_t>(chunks, std::thread::hardware_concurrency());
+    std::vector<std::jthread> pool;
+
+    for(std::size_t i=1;i<threads;i++)
+    {
+        pool.emplace_back(worker);
+    }
+
+    worker();
+}
 
 
 DartHit scoreFromPoint(BoardDimensions const &board, int x,int y)
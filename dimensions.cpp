@@ -10,13 +10,19 @@ BoardDimensions boardDimensions(HWND h)
     auto const clientHeight{client.bottom-client.top};
     auto const boardRadius   = min(clientWidth,clientHeight) /2 - 50;
 
+    return boardDimensions({clientWidth/2,clientHeight/2}, boardRadius);
+}
+
 
+
+BoardDimensions boardDimensions(Gdiplus::Point center, int boardRadius)
+{
     auto makeRect = [&](int radius)
     {
         return Gdiplus::Rect
         {
-            clientWidth/2 - radius,
-            clientHeight/2 - radius,
+            center.X - radius,
+            center.Y - radius,
             radius*2,
             radius*2,
         };
@@ -26,7 +32,7 @@ BoardDimensions boardDimensions(HWND h)
 
     BoardDimensions dimensions
     {
-        {clientWidth/2,clientHeight/2},
+        center,
     
         {
            boardRadius,
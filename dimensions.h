@@ -53,16 +53,6 @@ constexpr  double innerBullseye {12.7/2.0};
 }
 
 
-namespace Darts          // TODO : Gdiplus leaked horribly into here.
-{
-
-constexpr int  numDarts   {500};
-
-extern std::array<Gdiplus::PointF, numDarts> darts;           // -1.0 -> 1.0
-
-}
-
-
 auto inline   radians(double degrees)
 {
     return degrees * 2 * std::numbers::pi / 360;
@@ -104,6 +94,7 @@ struct BoardDimensions  // pixels
 
 
 BoardDimensions boardDimensions(HWND h);
+BoardDimensions boardDimensions(Gdiplus::Point center, int boardRadius);
 
 
 
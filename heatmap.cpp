@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include "heatmap.h"
+
+
+namespace
+{
+
+std::mutex                              publishedLock;
+std::shared_ptr<HeatmapPyramid const>   published;
+
+
+
+float slope(HeatmapLevel const &level)          // steepest change between neighbouring samples,  per pixel
+{
+    float steepest{};
+
+    for(int row=0;row<level.height;row++)
+    {
+        for(int column=0;column<level.width;column++)
+        {
+            if(column+1 < level.width)
+            {
+                steepest = (std::max)(steepest, std::abs(level.at(column+1,row) - level.at(column,row)));
+            }
+
+            if(row+1 < level.height)
+            {
+                steepest = (std::max)(steepest, std::abs(level.at(column,row+1) - level.at(column,row)));
+            }
+        }
+    }
+
+    return steepest / level.step;
+}
+
+
+float neighbourhood(HeatmapLevel const &level, int column, int row)
+{
+    auto highest = std::numeric_limits<float>::lowest();
+
+    for(int r = (std::max)(row-1, 0); r <= (std::min)(row+1, level.height-1); r++)
+    {
+        for(int c = (std::max)(column-1, 0); c <= (std::min)(column+1, level.width-1); c++)
+        {
+            highest = (std::max)(highest, level.at(c,r));
+        }
+    }
+
+    return highest;
+}
+
+}
+
+
+
+HeatmapLevel const &HeatmapPyramid::level(int pixelsPerSample) const
+{
+    for(auto const &level : levels)
+    {
+        if(level->step <= pixelsPerSample)
+        {
+            return *level;
+        }
+    }
+
+    return *levels.back();
+}
+
+
+
+void buildHeatmap(int clientWidth, int clientHeight, std::uint32_t darts, ObjectiveSpec const &spec, EvaluateFn const &evaluate, PublishFn const &publish)
+{
+    HeatmapPyramid  pyramid{ {}, spec, spec, 0, 0, std::numeric_limits<float>::lowest()};
+
+    for(int step=coarsestStep; step >= 1; step /= 2)
+    {
+        auto level = std::make_shared<HeatmapLevel>();
+
+        level->step   = step;
+        level->width  = (clientWidth  + step - 1) / step;
+        level->height = (clientHeight + step - 1) / step;
+        level->values.resize(static_cast<std::size_t>(level->width) * level->height);
+        level->evaluated = 0;
+
+        auto outcomes = std::make_shared<OutcomeTiles>(level->width, level->height, darts);
+
+        auto const parent = pyramid.levels.empty() ? nullptr : pyramid.levels.back();
+        auto const reach  = parent ? slope(*parent) * parent->step : 0.0f;      // how far a sample can rise above its parent's neighbourhood
+        auto const beat   = pyramid.bestScore;
+
+        std::vector<HeatmapSample>  samples;                                    // row major
+
+        for(int row=0;row<level->height;row++)
+        {
+            for(int column=0;column<level->width;column++)
+            {
+                if(parent)
+                {
+                    auto const parentColumn = (std::min)(column/2, parent->width-1);
+                    auto const parentRow    = (std::min)(row/2,    parent->height-1);
+
+                    if(neighbourhood(*parent, parentColumn, parentRow) + reach < beat)
+                    {
+                        level->values[row * level->width + column] = parent->at(parentColumn, parentRow);
+                        continue;
+                    }
+                }
+
+                samples.push_back({column * step, row * step});
+            }
+        }
+
+        std::vector<Outcome>    evaluated(samples.size());
+
+        evaluate(samples, evaluated);
+
+        for(std::size_t i=0;i<samples.size();i++)
+        {
+            auto const column = samples[i].x / step;
+            auto const row    = samples[i].y / step;
+            auto const value  = static_cast<float>(summarise(evaluated[i], spec).value);
+
+            outcomes->store(column, row, evaluated[i]);
+
+            level->values[row * level->width + column] = value;
+            level->evaluated++;
+
+            if(value > pyramid.bestScore)
+            {
+                pyramid.bestScore = value;
+                pyramid.bestX     = samples[i].x;
+                pyramid.bestY     = samples[i].y;
+            }
+        }
+
+        level->outcomes = std::move(outcomes);
+
+        pyramid.levels.push_back(std::move(level));
+
+        publish(std::make_shared<HeatmapPyramid const>(pyramid));
+    }
+}
+
+
+
+std::shared_ptr<HeatmapPyramid const> rescoreHeatmap(HeatmapPyramid const &original, ObjectiveSpec const &spec)
+{
+    HeatmapPyramid  pyramid{ {}, spec, original.prunedFor, 0, 0, std::numeric_limits<float>::lowest()};
+
+    for(auto const &from : original.levels)
+    {
+        auto level = std::make_shared<HeatmapLevel>(*from);
+
+        auto const parent = pyramid.levels.empty() ? nullptr : pyramid.levels.back();
+
+        for(int row=0;row<level->height;row++)
+        {
+            for(int column=0;column<level->width;column++)
+            {
+                auto &value = level->values[row * level->width + column];
+
+                if(!level->outcomes->has(column,row))
+                {
+                    value = parent->at((std::min)(column/2, parent->width-1), (std::min)(row/2, parent->height-1));
+                    continue;
+                }
+
+                value = static_cast<float>(level->outcomes->summary(column, row, spec).value);
+
+                if(value > pyramid.bestScore)
+                {
+                    pyramid.bestScore = value;
+                    pyramid.bestX     = column * level->step;
+                    pyramid.bestY     = row    * level->step;
+                }
+            }
+        }
+
+        pyramid.levels.push_back(std::move(level));
+    }
+
+    return std::make_shared<HeatmapPyramid const>(std::move(pyramid));
+}
+
+
+
+void publishHeatmap(std::shared_ptr<HeatmapPyramid const> pyramid)
+{
+    std::lock_guard guard{publishedLock};
+
+    published = std::move(pyramid);
+}
+
+
+std::shared_ptr<HeatmapPyramid const> publishedHeatmap()
+{
+    std::lock_guard guard{publishedLock};
+
+    return published;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "outcome.h"
+
+
+/*
+
+    An objective (by default the expected score) over the client area,  computed
+    coarse to fine.
+
+    Level 0 samples every coarsestStep pixels.  Each following level halves the
+    step,  but only evaluates samples whose parent neighbourhood could still
+    beat the best score of the coarser levels;  the rest are copied from the
+    parent.  So every level is a complete image and the pyramid doubles as a
+    mipmap.
+
+    A level's samples are chosen before any of them is evaluated,  and handed
+    to the evaluator in one batch,  so it is free to visit them in whatever
+    order suits the cache.
+
+    The outcome of every evaluated sample is kept,  so the pyramid can be
+    rescored for a different objective without evaluating anything.  The
+    samples skipped stay the ones skipped for the objective it was built with,
+    which may hide a better point for the new one;  so a rescored best is only
+    approximate until the pyramid is rebuilt.
+
+*/
+
+
+struct HeatmapLevel
+{
+    int                 step;               // client pixels per sample
+    int                 width;              // samples
+    int                 height;
+    std::vector<float>  values;             // row major,  of the objective
+    int                 evaluated;          // samples actually scored on this level
+
+    std::shared_ptr<OutcomeTiles const>     outcomes;       // of the evaluated samples
+
+    float at(int column, int row) const
+    {
+        return values[row * width + column];
+    }
+};
+
+
+struct HeatmapPyramid
+{
+    std::vector<std::shared_ptr<HeatmapLevel const>>    levels;     // coarsest first
+
+    ObjectiveSpec   spec;
+    ObjectiveSpec   prunedFor;                                      // the objective that chose the samples skipped
+
+    int             bestX;                                          // client coordinates
+    int             bestY;
+    float           bestScore;                                      // of the objective
+
+    HeatmapLevel const &level(int pixelsPerSample) const;           // the coarsest level at least this fine
+
+    bool approximate() const                                        // a skipped sample might beat the best
+    {
+        return spec != prunedFor;
+    }
+};
+
+
+constexpr int   coarsestStep{32};
+
+
+struct HeatmapSample                                                            // client coordinates
+{
+    int x;
+    int y;
+};
+
+using EvaluateFn = std::function<void(std::span<HeatmapSample const> samples, std::span<Outcome> outcomes)>;
+using PublishFn  = std::function<void(std::shared_ptr<HeatmapPyramid const>)>;
+
+void buildHeatmap(int clientWidth, int clientHeight, std::uint32_t darts, ObjectiveSpec const &spec, EvaluateFn const &evaluate, PublishFn const &publish);
+
+std::shared_ptr<HeatmapPyramid const> rescoreHeatmap(HeatmapPyramid const &pyramid, ObjectiveSpec const &spec);
+
+
+void                                    publishHeatmap(std::shared_ptr<HeatmapPyramid const> pyramid);
+std::shared_ptr<HeatmapPyramid const>   publishedHeatmap();
@@ -0,0 +1,373 @@
+#include <Windows.h>
+#include <compressapi.h>
+
+#pragma comment(lib,"cabinet")
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "win32.h"
+#include "heatmapFile.h"
+
+
+namespace
+{
+
+constexpr float quantumSteps{(std::numeric_limits<std::uint16_t>::max)()};
+
+}
+
+
+namespace HeatmapFile
+{
+
+Writer::Writer(std::filesystem::path const &path, std::uint32_t width, std::uint32_t height) : file{path, std::ios::binary | std::ios::trunc}
+{
+    if(!file)
+    {
+        throw std::runtime_error{"heatmap file : can't create " + path.string()};
+    }
+
+    if(width == 0 || height == 0)
+    {
+        throw std::invalid_argument{"heatmap file : empty map"};
+    }
+
+    header.magic       = magic;
+    header.version     = version;
+    header.tileSize    = tileSize;
+    header.width       = width;
+    header.height      = height;
+    header.tilesX      = (width  + tileSize - 1) / tileSize;
+    header.tilesY      = (height + tileSize - 1) / tileSize;
+    header.bestValue   = std::numeric_limits<float>::lowest();
+
+    index.resize(static_cast<std::size_t>(header.tilesX) * header.tilesY);
+    band.reserve(static_cast<std::size_t>(width) * tileSize);
+
+    COMPRESSOR_HANDLE   handle{};
+
+    if(!CreateCompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &handle))
+    {
+        throwLastError("CreateCompressor");
+    }
+
+    compressor.reset(handle, [](void *h){ CloseCompressor(static_cast<COMPRESSOR_HANDLE>(h)); });
+
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    written = sizeof(header);
+}
+
+
+void Writer::appendRow(std::span<float const> row)
+{
+    if(row.size() != header.width)
+    {
+        throw std::invalid_argument{"heatmap file : row is the wrong width"};
+    }
+
+    if(rows == header.height)
+    {
+        throw std::logic_error{"heatmap file : too many rows"};
+    }
+
+    for(std::uint32_t column=0;column<header.width;column++)
+    {
+        if(row[column] > header.bestValue)
+        {
+            header.bestValue = row[column];
+            header.bestX     = column;
+            header.bestY     = rows;
+        }
+    }
+
+    band.insert(band.end(), row.begin(), row.end());
+    rows++;
+
+    if(   band.size() == static_cast<std::size_t>(header.width) * tileSize
+       || rows        == header.height)
+    {
+        flushBand();
+    }
+}
+
+
+void Writer::flushBand()
+{
+    auto const bandRows = static_cast<std::uint32_t>(band.size() / header.width);
+    auto const tileY    = (rows - 1) / tileSize;
+
+    std::vector<float>          values(tileValues);
+    std::vector<std::uint16_t>  q(tileValues);
+    std::vector<std::uint16_t>  delta(tileValues);
+    std::vector<std::byte>      compressed(tileValues * sizeof(std::uint16_t));
+
+    for(std::uint32_t tileX=0;tileX<header.tilesX;tileX++)
+    {
+        for(std::uint32_t r=0;r<tileSize;r++)
+        {
+            auto const row = (std::min)(r, bandRows-1);
+
+            for(std::uint32_t c=0;c<tileSize;c++)
+            {
+                auto const column = (std::min)(tileX * tileSize + c, header.width-1);
+
+                values[r * tileSize + c] = band[static_cast<std::size_t>(row) * header.width + column];
+            }
+        }
+
+        auto const [lowest, highest] = std::minmax_element(values.begin(), values.end());
+
+        auto &entry = index[tileY * header.tilesX + tileX];
+
+        entry.base  = *lowest;
+        entry.scale = (*highest - *lowest) / quantumSteps;
+
+        for(std::size_t i=0;i<tileValues;i++)
+        {
+            q[i] = entry.scale > 0 ? static_cast<std::uint16_t>(std::lround((values[i] - entry.base) / entry.scale))
+                                   : 0;
+
+            delta[i] = i % tileSize ? static_cast<std::uint16_t>(q[i] - q[i-1])            // neighbours are close,  so deltas are mostly small
+                                    : q[i];
+        }
+
+        SIZE_T  size{};
+
+        auto const packed = Compress(static_cast<COMPRESSOR_HANDLE>(compressor.get()),
+                                     delta.data(), tileValues * sizeof(std::uint16_t),
+                                     compressed.data(), compressed.size(),
+                                     &size);
+
+        if(!packed && GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+        {
+            throwLastError("Compress");
+        }
+
+        entry.offset = written;
+
+        if(packed && size < compressed.size())
+        {
+            entry.codec = Codec::xpress;
+            entry.bytes = static_cast<std::uint32_t>(size);
+
+            file.write(reinterpret_cast<char const*>(compressed.data()), size);
+        }
+        else
+        {
+            entry.codec = Codec::raw;
+            entry.bytes = static_cast<std::uint32_t>(tileValues * sizeof(std::uint16_t));
+
+            file.write(reinterpret_cast<char const*>(q.data()), entry.bytes);
+        }
+
+        written += entry.bytes;
+    }
+
+    band.clear();
+
+    if(!file)
+    {
+        throw std::runtime_error{"heatmap file : write failed"};
+    }
+}
+
+
+void Writer::finish()
+{
+    if(rows != header.height)
+    {
+        throw std::logic_error{"heatmap file : finished early"};
+    }
+
+    header.indexOffset = written;
+
+    file.write(reinterpret_cast<char const*>(index.data()), index.size() * sizeof(TileEntry));
+    written += index.size() * sizeof(TileEntry);
+
+    file.seekp(0);
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    file.close();                       // so a Reader can open it,  Reader doesn't share write access
+
+    if(!file)
+    {
+        throw std::runtime_error{"heatmap file : write failed"};
+    }
+}
+
+
+Reader Reader::open(std::filesystem::path const &path)
+{
+    Handle file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)};
+
+    if(file.h == INVALID_HANDLE_VALUE)
+    {
+        throwLastError("CreateFile");
+    }
+
+    LARGE_INTEGER size{};
+
+    if(!GetFileSizeEx(file.h, &size))
+    {
+        throwLastError("GetFileSizeEx");
+    }
+
+    if(static_cast<std::uint64_t>(size.QuadPart) < sizeof(Header))
+    {
+        throw std::runtime_error{"heatmap file : truncated header"};
+    }
+
+    Handle mapping{ CreateFileMappingW(file.h, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+
+    if(mapping.h == nullptr)
+    {
+        throwLastError("CreateFileMapping");
+    }
+
+    auto view = static_cast<std::byte const*>(MapViewOfFile(mapping.h, FILE_MAP_READ, 0, 0, 0));
+
+    if(view == nullptr)
+    {
+        throwLastError("MapViewOfFile");
+    }
+
+    Reader  reader;
+
+    reader.image.reset(view, [](std::byte const *p){ UnmapViewOfFile(p); });
+    reader.imageSize = static_cast<std::size_t>(size.QuadPart);
+
+    auto const &header = reader.header();
+    auto const  tiles  = static_cast<std::uint64_t>(header.tilesX) * header.tilesY;
+
+    if(   header.magic       != magic
+       || header.version     != version
+       || header.tileSize    != tileSize
+       || header.tilesX      != (header.width  + tileSize - 1) / tileSize
+       || header.tilesY      != (header.height + tileSize - 1) / tileSize)
+    {
+        throw std::runtime_error{"heatmap file : not a version 1 heatmap"};
+    }
+
+    if(   header.indexOffset == 0
+       || header.indexOffset + tiles * sizeof(TileEntry) > reader.imageSize)
+    {
+        throw std::runtime_error{"heatmap file : no index,  the writer didn't finish"};
+    }
+
+    reader.index = reinterpret_cast<TileEntry const*>(view + header.indexOffset);
+
+    for(std::uint64_t i=0;i<tiles;i++)
+    {
+        if(reader.index[i].offset + reader.index[i].bytes > header.indexOffset)
+        {
+            throw std::runtime_error{"heatmap file : tile out of range"};
+        }
+    }
+
+    DECOMPRESSOR_HANDLE handle{};
+
+    if(!CreateDecompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &handle))
+    {
+        throwLastError("CreateDecompressor");
+    }
+
+    reader.decompressor.reset(handle, [](void *h){ CloseDecompressor(static_cast<DECOMPRESSOR_HANDLE>(h)); });
+    reader.scratch.resize(tileValues);
+
+    return reader;
+}
+
+
+void Reader::tile(std::uint32_t tileX, std::uint32_t tileY, std::span<float> values) const
+{
+    if(   tileX >= header().tilesX
+       || tileY >= header().tilesY
+       || values.size() < tileValues)
+    {
+        throw std::out_of_range{"heatmap file : no such tile"};
+    }
+
+    auto const &entry = this->entry(tileX, tileY);
+    auto const  data  = image.get() + entry.offset;
+    auto const  bytes = tileValues * sizeof(std::uint16_t);
+
+    if(entry.codec == Codec::raw)
+    {
+        if(entry.bytes != bytes)
+        {
+            throw std::runtime_error{"heatmap file : bad raw tile"};
+        }
+
+        std::memcpy(scratch.data(), data, bytes);
+    }
+    else
+    {
+        SIZE_T  size{};
+
+        if(!Decompress(static_cast<DECOMPRESSOR_HANDLE>(decompressor.get()), data, entry.bytes, scratch.data(), bytes, &size))
+        {
+            throwLastError("Decompress");
+        }
+
+        if(size != bytes)
+        {
+            throw std::runtime_error{"heatmap file : bad compressed tile"};
+        }
+
+        for(std::size_t i=0;i<tileValues;i++)
+        {
+            if(i % tileSize)
+            {
+                scratch[i] = static_cast<std::uint16_t>(scratch[i] + scratch[i-1]);
+            }
+        }
+    }
+
+    for(std::size_t i=0;i<tileValues;i++)
+    {
+        values[i] = entry.base + entry.scale * scratch[i];
+    }
+}
+
+
+void Reader::region(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h, std::span<float> values) const
+{
+    if(   x + w > width()
+       || y + h > height()
+       || values.size() < static_cast<std::size_t>(w) * h)
+    {
+        throw std::out_of_range{"heatmap file : region outside the map"};
+    }
+
+    if(w == 0 || h == 0)
+    {
+        return;
+    }
+
+    std::vector<float>  decoded(tileValues);
+
+    for(auto tileY = y / tileSize; tileY <= (y + h - 1) / tileSize; tileY++)
+    {
+        for(auto tileX = x / tileSize; tileX <= (x + w - 1) / tileSize; tileX++)
+        {
+            tile(tileX, tileY, decoded);
+
+            auto const top    = (std::max)(y,     tileY * tileSize);
+            auto const bottom = (std::min)(y + h, tileY * tileSize + tileSize);
+            auto const left   = (std::max)(x,     tileX * tileSize);
+            auto const right  = (std::min)(x + w, tileX * tileSize + tileSize);
+
+            for(auto row=top; row<bottom; row++)
+            {
+                std::copy(decoded.begin() + (row - tileY * tileSize) * tileSize + (left  - tileX * tileSize),
+                          decoded.begin() + (row - tileY * tileSize) * tileSize + (right - tileX * tileSize),
+                          values.begin()  + static_cast<std::size_t>(row - y) * w + (left - x));
+            }
+        }
+    }
+}
+
+}
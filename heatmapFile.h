@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <vector>
+
+
+/*
+
+    Heatmap file layout  (little-endian)
+
+        0               Header              64 bytes
+        64              tiles               in the order they were written
+        indexOffset     TileEntry[tilesX * tilesY]      row major
+
+    The map is cut into tileSize x tileSize tiles,  edge tiles are padded by
+    repeating the last row and column.  Each tile is quantised to 16 bits
+    between its own minimum and maximum,  value = base + scale * q,  then
+    delta coded along rows and XPRESS compressed.  A tile that doesn't shrink
+    is stored raw.
+
+    The index is written last,  so a writer never has to hold more than one
+    row of tiles;  indexOffset stays 0 until it is,  and a file without an
+    index is rejected.
+
+*/
+
+
+namespace HeatmapFile
+{
+
+constexpr std::array<char,8>    magic       {'H','E','A','T','T','I','L','E'};
+constexpr std::uint32_t         version     {1};
+constexpr std::uint32_t         tileSize    {64};
+constexpr std::size_t           tileValues  {tileSize * tileSize};
+
+
+enum class Codec : std::uint32_t
+{
+    raw,                    // uint16 q[tileSize][tileSize]
+    xpress,                 // the same,  delta coded then XPRESS Huffman compressed
+};
+
+
+struct Header
+{
+    std::array<char,8>  magic;
+    std::uint32_t       version;
+    std::uint32_t       tileSize;
+    std::uint32_t       width;          // samples
+    std::uint32_t       height;
+    std::uint32_t       tilesX;
+    std::uint32_t       tilesY;
+    std::uint64_t       indexOffset;    // bytes from start of file,  0 while being written
+    std::uint32_t       bestX;          // the highest sample,  before quantisation
+    std::uint32_t       bestY;
+    float               bestValue;
+    std::array<std::uint32_t,3> reserved;
+};
+
+static_assert(sizeof(Header) == 64);
+
+
+struct TileEntry
+{
+    std::uint64_t       offset;         // bytes from start of file
+    std::uint32_t       bytes;
+    Codec               codec;
+    float               scale;
+    float               base;           // the value of q = 0
+};
+
+
+
+class Writer                            // takes the map a row at a time,  as a sweep produces it
+{
+public:
+
+    Writer(std::filesystem::path const &path, std::uint32_t width, std::uint32_t height);
+
+    void appendRow(std::span<float const> row);
+    void finish();                      // after the last row.  Writes the index,  patches the header and closes the file
+
+    std::uint64_t bytesWritten() const
+    {
+        return written;
+    }
+
+private:
+
+    void flushBand();
+
+    std::ofstream               file;
+    Header                      header{};
+    std::vector<TileEntry>      index;
+    std::vector<float>          band;           // tileSize rows
+    std::uint32_t               rows{};
+    std::uint64_t               written{};
+    std::shared_ptr<void>       compressor;
+};
+
+
+
+class Reader                            // memory-maps the file and decompresses only the tiles asked for.  One thread at a time
+{
+public:
+
+    static Reader open(std::filesystem::path const &path);
+
+    Header const &header() const
+    {
+        return *reinterpret_cast<Header const*>(image.get());
+    }
+
+    std::uint32_t width()  const {  return header().width;  }
+    std::uint32_t height() const {  return header().height; }
+
+    TileEntry const &entry(std::uint32_t tileX, std::uint32_t tileY) const
+    {
+        return index[tileY * header().tilesX + tileX];
+    }
+
+    void tile(std::uint32_t tileX, std::uint32_t tileY, std::span<float> values) const;       // tileValues,  row major,  padded
+
+    void region(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h, std::span<float> values) const;    // w*h,  row major
+
+private:
+
+    Reader() = default;
+
+    std::shared_ptr<std::byte const>    image;
+    std::size_t                         imageSize{};
+    TileEntry const                    *index{};
+    std::shared_ptr<void>               decompressor;
+    mutable std::vector<std::uint16_t>  scratch;
+};
+
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "optimizer.h"
+
+
+namespace
+{
+
+constexpr int       maxIterations   {200};
+
+constexpr float     reflection      {1.0f};
+constexpr float     expansion       {2.0f};
+constexpr float     contraction     {0.5f};
+constexpr float     shrinkage       {0.5f};
+
+
+struct Vertex
+{
+    Point2  point;
+    double  value;
+};
+
+
+Point2 along(Point2 from, Point2 to, float t)                     // from + t (to - from)
+{
+    return { from[0] + t * (to[0] - from[0]),
+             from[1] + t * (to[1] - from[1])};
+}
+
+
+float diameter(std::array<Vertex,3> const &simplex)
+{
+    float widest{};
+
+    for(int i=0;i<3;i++)
+    {
+        for(int j=i+1;j<3;j++)
+        {
+            widest = (std::max)(widest, std::hypot(simplex[i].point[0] - simplex[j].point[0],
+                                                   simplex[i].point[1] - simplex[j].point[1]));
+        }
+    }
+
+    return widest;
+}
+
+}
+
+
+
+OptimizeRun nelderMead(ObjectiveFn const &objective, Point2 start, float step, float tolerance)
+{
+    OptimizeRun     run{start, start, 0, 0, false};
+
+    auto evaluate = [&](Point2 point)
+    {
+        run.evaluations++;
+
+        return Vertex{point, objective(point[0], point[1])};
+    };
+
+    std::array<Vertex,3>    simplex
+    {
+        evaluate(start),
+        evaluate({start[0] + step, start[1]}),
+        evaluate({start[0],        start[1] + step}),
+    };
+
+    for(int iteration=0; iteration < maxIterations; iteration++)
+    {
+        std::sort(simplex.begin(), simplex.end(), [](Vertex const &a, Vertex const &b){ return a.value > b.value; });      // best first
+
+        if(diameter(simplex) < tolerance)
+        {
+            run.converged = true;
+            break;
+        }
+
+        auto const &best   = simplex[0];
+        auto const &second = simplex[1];
+        auto       &worst  = simplex[2];
+
+        auto const centroid  = along(best.point, second.point, 0.5f);
+        auto const reflected = evaluate(along(centroid, worst.point, -reflection));
+
+        if(reflected.value > best.value)
+        {
+            auto const expanded = evaluate(along(centroid, worst.point, -expansion));
+
+            worst = expanded.value > reflected.value ? expanded : reflected;
+        }
+        else if(reflected.value > second.value)
+        {
+            worst = reflected;
+        }
+        else
+        {
+            auto const outside    = reflected.value > worst.value;
+            auto const contracted = evaluate(along(centroid, outside ? reflected.point : worst.point, contraction));
+
+            if(contracted.value > (outside ? reflected.value : worst.value))
+            {
+                worst = contracted;
+            }
+            else
+            {
+                for(int i=1;i<3;i++)
+                {
+                    simplex[i] = evaluate(along(best.point, simplex[i].point, shrinkage));
+                }
+            }
+        }
+    }
+
+    auto const &best = *std::max_element(simplex.begin(), simplex.end(), [](Vertex const &a, Vertex const &b){ return a.value < b.value; });
+
+    run.best  = best.point;
+    run.value = best.value;
+
+    return run;
+}
+
+
+
+OptimizeResult multiStart(ObjectiveFn const &objective, std::vector<Point2> const &starts, float step, float tolerance)
+{
+    OptimizeResult  result{ {}, {}, std::numeric_limits<double>::lowest(), 0};
+
+    for(auto const &start : starts)
+    {
+        auto const run = nelderMead(objective, start, step, tolerance);
+
+        result.evaluations += run.evaluations;
+
+        if(run.value > result.value)
+        {
+            result.value = run.value;
+            result.best  = run.best;
+        }
+
+        result.runs.push_back(run);
+    }
+
+    return result;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <vector>
+
+
+/*
+
+    Maximise an objective over the board by Nelder-Mead from several starts.
+
+    Every evaluation throws the same sample bank,  so the objective is a
+    deterministic function of the aim-point (common random numbers) and the
+    simplex can compare neighbouring points without noise.  Darts are scored at
+    whole pixels,  so the field is piecewise constant and has no useful
+    gradient;  hence a derivative-free method.
+
+    A start stops when its simplex has shrunk below the tolerance.
+
+*/
+
+
+using Point2        = std::array<float,2>;                         // client coordinates,  sub-pixel
+using ObjectiveFn   = std::function<double(float x, float y)>;
+
+
+struct OptimizeRun
+{
+    Point2  start;
+    Point2  best;
+    double  value;
+    int     evaluations;
+    bool    converged;          // rather than running out of iterations
+};
+
+
+struct OptimizeResult
+{
+    std::vector<OptimizeRun>    runs;
+
+    Point2  best;
+    double  value;
+    int     evaluations;        // over all the runs
+};
+
+
+OptimizeRun     nelderMead(ObjectiveFn const &objective, Point2 start, float step, float tolerance);
+
+OptimizeResult  multiStart(ObjectiveFn const &objective, std::vector<Point2> const &starts, float step, float tolerance);
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cmath>
+
+#include "outcome.h"
+
+
+namespace
+{
+
+template <typename PROBABILITY>
+OutcomeSummary summariseProbabilities(PROBABILITY probability, ObjectiveSpec const &spec)
+{
+    OutcomeSummary  summary{};
+    double          second{};
+    double          onBoard{};
+
+    for(int bed=0;bed<Bed::count;bed++)
+    {
+        auto const p      = probability(bed);
+        auto const points = Bed::points(bed);
+
+        summary.mean += p * points;
+        second       += p * points * points;
+        onBoard      += p;
+
+        if(points >= spec.threshold)
+        {
+            summary.atLeast += p;
+        }
+    }
+
+    if(spec.threshold <= 0)
+    {
+        summary.atLeast += (std::max)(0.0, 1 - onBoard);        // a miss scores 0
+    }
+
+    summary.variance = (std::max)(0.0, second - summary.mean * summary.mean);
+
+    switch(spec.objective)
+    {
+    case Objective::mean:           summary.value = summary.mean;                                           break;
+    case Objective::atLeast:        summary.value = summary.atLeast;                                        break;
+    case Objective::riskAdjusted:   summary.value = summary.mean - spec.lambda * std::sqrt(summary.variance);  break;
+    }
+
+    return summary;
+}
+
+}
+
+
+
+OutcomeSummary summarise(Outcome const &outcome, ObjectiveSpec const &spec)
+{
+    auto const darts = (std::max)(outcome.darts, 1u);
+
+    return summariseProbabilities([&](int bed){ return static_cast<double>(outcome.counts[bed]) / darts; }, spec);
+}
+
+
+
+OutcomeTiles::OutcomeTiles(int width, int height, std::uint32_t darts)
+    : tilesAcross{ (width + tileSide - 1) / tileSide},
+      scale      { (std::min)(1.0, 65535.0 / (std::max)(darts, 1u))},
+      total      { (std::max)(darts, 1u) * scale},
+      tiles      ( static_cast<std::size_t>(tilesAcross) * ((height + tileSide - 1) / tileSide))
+{
+}
+
+
+void OutcomeTiles::store(int column, int row, Outcome const &outcome)
+{
+    auto &tile = tiles[(row / tileSide) * tilesAcross + column / tileSide];
+
+    if(!tile)
+    {
+        tile = std::make_unique<Tile>();
+    }
+
+    auto const aim = (row % tileSide) * tileSide + column % tileSide;
+
+    for(int bed=0;bed<Bed::count;bed++)
+    {
+        tile->weights[bed][aim] = static_cast<std::uint16_t>(std::lround(outcome.counts[bed] * scale));
+    }
+
+    tile->present |= std::uint64_t{1} << aim;
+}
+
+
+bool OutcomeTiles::has(int column, int row) const
+{
+    auto const &tile = tiles[(row / tileSide) * tilesAcross + column / tileSide];
+    auto const  aim  = (row % tileSide) * tileSide + column % tileSide;
+
+    return tile && (tile->present >> aim) & 1;
+}
+
+
+OutcomeSummary OutcomeTiles::summary(int column, int row, ObjectiveSpec const &spec) const
+{
+    auto const &tile = *tiles[(row / tileSide) * tilesAcross + column / tileSide];
+    auto const  aim  = (row % tileSide) * tileSide + column % tileSide;
+
+    return summariseProbabilities([&](int bed){ return tile.weights[bed][aim] / total; }, spec);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "window.h"
+
+
+/*
+
+    Where the darts aimed at one point land,  bed by bed,  rather than just the
+    average score.  Every objective findBest can optimise is computed from these
+    counts,  so changing the objective never re-scores any darts.
+
+*/
+
+
+namespace Bed
+{
+
+constexpr int   count{62};              // single 1-20,  double 1-20,  triple 1-20,  outer bull,  bull
+constexpr int   outerBull{60};
+constexpr int   bull{61};
+
+
+constexpr int index(DartHit hit)        // -1 for a miss
+{
+    if(hit.score == 0)
+    {
+        return -1;
+    }
+
+    if(hit.score == 25)
+    {
+        return outerBull;
+    }
+
+    if(hit.score == 50)
+    {
+        return bull;
+    }
+
+    return (hit.multiplier-1) * 20 + (hit.score-1);
+}
+
+
+constexpr int points(int bed)
+{
+    if(bed == outerBull)
+    {
+        return 25;
+    }
+
+    if(bed == bull)
+    {
+        return 50;
+    }
+
+    return (bed / 20 + 1) * (bed % 20 + 1);
+}
+
+}
+
+
+
+struct Outcome                          // one aim-point
+{
+    std::array<std::uint32_t, Bed::count>   counts;
+    std::uint32_t                           darts;      // including misses
+};
+
+
+enum class Objective
+{
+    mean,
+    atLeast,                            // probability of scoring at least threshold
+    riskAdjusted,                       // mean - lambda * standard deviation
+};
+
+
+struct ObjectiveSpec
+{
+    Objective   objective;
+    double      threshold;
+    double      lambda;
+
+    bool operator==(ObjectiveSpec const &) const = default;
+};
+
+
+struct OutcomeSummary
+{
+    double      mean;
+    double      variance;
+    double      atLeast;
+    double      value;                  // of the objective
+};
+
+
+
+// Outcomes for a grid of aim-points,  stored in 8x8 tiles of 16-bit weights.
+// Only tiles holding a stored aim-point are allocated.
+
+class OutcomeTiles
+{
+public:
+
+    static constexpr int    tileSide{8};
+    static constexpr int    perTile {tileSide * tileSide};
+
+    OutcomeTiles(int width, int height, std::uint32_t darts);
+
+    void store(int column, int row, Outcome const &outcome);
+    bool has  (int column, int row) const;
+
+    OutcomeSummary  summary(int column, int row, ObjectiveSpec const &spec) const;
+
+private:
+
+    struct Tile
+    {
+        std::array<std::array<std::uint16_t, perTile>, Bed::count>  weights;
+        std::uint64_t                                               present;
+    };
+
+    int                                 tilesAcross;
+    double                              scale;          // weight per dart
+    double                              total;          // weight of every dart
+    std::vector<std::unique_ptr<Tile>>  tiles;
+};
+
+
+OutcomeSummary summarise(Outcome const &outcome, ObjectiveSpec const &spec);
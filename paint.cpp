@@ -10,6 +10,7 @@
 #include <system_error>
 #include <numbers>
 #include <tuple>
+#include <algorithm>
 
 #include "print.h"
 #include "window.h"
@@ -17,6 +18,8 @@
 
 
 #include "dimensions.h"
+#include "heatmap.h"
+#include "sampleBank.h"
 
 
 
@@ -78,6 +81,53 @@ void paintBoard(Gdiplus::Graphics   &window, BoardDimensions const &board)
 }
 
 
+void paintHeatmap(Gdiplus::Graphics   &window)
+{
+    constexpr int   pixelsPerSample{4};        // finer is lost under the darts
+
+    auto const pyramid = publishedHeatmap();
+
+    if(!pyramid)
+    {
+        return;
+    }
+
+    auto const &level   = pyramid->level(pixelsPerSample);
+    auto const  range   = std::minmax_element(level.values.begin(), level.values.end());
+    auto const  lowest  = *range.first;
+    auto const  spread  = (std::max)(*range.second - lowest, 1e-6f);        // objectives aren't all scores
+
+    Gdiplus::Bitmap     overlay{level.width, level.height, PixelFormat32bppARGB};
+    Gdiplus::Rect       all{0, 0, level.width, level.height};
+    Gdiplus::BitmapData pixels{};
+
+    overlay.LockBits(&all, Gdiplus::ImageLockModeWrite, PixelFormat32bppARGB, &pixels);
+
+    for(int row=0;row<level.height;row++)
+    {
+        auto line = reinterpret_cast<UINT32*>(static_cast<BYTE*>(pixels.Scan0) + row * pixels.Stride);
+
+        for(int column=0;column<level.width;column++)
+        {
+            auto const value = level.at(column,row);
+            auto const hot   = static_cast<UINT32>(255 * (value - lowest) / spread);
+
+            line[column] = value > lowest ? (0x80u << 24) | (hot << 16) | (255 - hot)
+                                          : 0;
+        }
+    }
+
+    overlay.UnlockBits(&pixels);
+
+    window.SetInterpolationMode(Gdiplus::InterpolationModeNearestNeighbor);
+    window.SetPixelOffsetMode  (Gdiplus::PixelOffsetModeHalf);
+
+    window.DrawImage(&overlay, Gdiplus::Rect{0, 0, level.width*level.step, level.height*level.step});
+
+    window.SetPixelOffsetMode  (Gdiplus::PixelOffsetModeDefault);
+}
+
+
 void paintAimAndDarts(Gdiplus::Graphics   &window,BoardDimensions const &board)
 {
     static Gdiplus::Pen         whitePen    {Gdiplus::Color::White};
@@ -86,10 +136,12 @@ void paintAimAndDarts(Gdiplus::Graphics   &window,BoardDimensions const &board)
 
     auto radius = static_cast<int>(board.radius.outerTriple * (accuracy / 100.0));
 
-    for(auto const &dart : Darts::darts)
+    auto const darts  = Darts::bank.view();
+
+    for(std::size_t i=0;i<darts.size();i++)
     {
-        auto x = static_cast<int>(mousePosition.x + radius * dart.X);
-        auto y = static_cast<int>(mousePosition.y + radius * dart.Y);
+        auto x = static_cast<int>(mousePosition.x + radius * darts.x[i]);
+        auto y = static_cast<int>(mousePosition.y + radius * darts.y[i]);
 
         window.DrawEllipse(&whitePen, x, y, 1,1);
         window.DrawEllipse(&greenPen, x-1, y-1, 2,2);
@@ -121,12 +173,18 @@ void paint(HWND h,WPARAM w, LPARAM l)
 
     window.Clear(Gdiplus::Color::White);
     paintBoard      (window,board);
+    paintHeatmap    (window);
     paintAimAndDarts(window,board);
 
 
     static Gdiplus::SolidBrush yellowBrush{Gdiplus::Color::Yellow};
+    static Gdiplus::Pen        yellowPen  {Gdiplus::Color::Yellow, 2.0f};
 
-    if(bestPoint.x != 0)
+    if(bestPoint.x != 0 && bestApproximate)                 // hollow,  the heatmap wasn't pruned for this objective
+    {
+        window.DrawEllipse(&yellowPen,bestPoint.x-4, bestPoint.y-4,8,8);
+    }
+    else if(bestPoint.x != 0)
     {
         window.FillEllipse(&yellowBrush,bestPoint.x-3, bestPoint.y-3,6,6);
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+
+/*
+
+    Workers that share their work through an atomic index,  one thread per
+    hardware thread.  Each worker copies the callable and keeps taking items
+    until there are none left.
+
+*/
+
+
+template <typename WORKER>
+[[nodiscard]] std::vector<std::jthread> startOnAllCores(WORKER const &worker)      // joined when the vector goes
+{
+    std::vector<std::jthread>   pool;
+
+    for(unsigned i=0; i < (std::max)(1u, std::thread::hardware_concurrency()); i++)
+    {
+        pool.emplace_back(worker);
+    }
+
+    return pool;
+}
+
+
+template <typename WORKER>
+void runOnAllCores(WORKER const &worker)                                            // returns when every worker has
+{
+    auto const pool = startOnAllCores(worker);
+}
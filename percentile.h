@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+template <typename T>
+T percentile(std::vector<T> const &sorted, double p)           // p from 0 to 1,  nearest rank.  0 without any values
+{
+    return sorted.empty() ? T{} : sorted[static_cast<std::size_t>(p * (sorted.size()-1))];
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+#include "percentile.h"
+
+
+/*
+
+    Aim queries over a local (AF_UNIX) stream socket.
+
+    A client writes fixed size Requests and reads one fixed size Response per
+    request,  matched by id.  Requests may be pipelined;  responses to one
+    connection come back in the order they were sent.  Little-endian,  millimetres.
+
+*/
+
+
+namespace Query
+{
+
+constexpr char const    defaultSocket[]{"dartsScore.sock"};
+
+
+enum class Kind : std::uint32_t
+{
+    expectedScore,          // at (x,y) for the scatter model
+    bestAim,                // for the scatter model,  from the aim table
+    stats,                  // server latency percentiles
+};
+
+
+enum class Status : std::uint32_t
+{
+    ok,
+    badRequest,
+    unavailable,            // bestAim without an aim table
+};
+
+
+struct Request
+{
+    std::uint32_t   id;
+    Kind            kind;
+    float           x;
+    float           y;
+    float           sigmaX;
+    float           sigmaY;
+    float           rho;
+    float           reserved;
+};
+
+
+struct Response
+{
+    std::uint32_t   id;
+    Status          status;
+    float           x;
+    float           y;
+    float           expected;
+    std::uint32_t   count;          // stats : requests answered
+    float           p50;            // stats : microseconds from arrival to reply
+    float           p90;
+    float           p99;
+    float           reserved;
+};
+
+static_assert(sizeof(Request)  == 32);
+static_assert(sizeof(Response) == 40);
+
+
+
+class Latencies
+{
+public:
+
+    void record(float microseconds)
+    {
+        std::lock_guard guard{lock};
+
+        if(samples.size() < capacity)
+        {
+            samples.push_back(microseconds);
+        }
+        else
+        {
+            samples[total % capacity] = microseconds;
+        }
+
+        total++;
+    }
+
+
+    void fill(Response &response)
+    {
+        std::vector<float>  sorted;
+        {
+            std::lock_guard guard{lock};
+
+            sorted         = samples;
+            response.count = static_cast<std::uint32_t>(total);
+        }
+
+        std::sort(sorted.begin(), sorted.end());
+
+        response.p50 = percentile(sorted, 0.50);
+        response.p90 = percentile(sorted, 0.90);
+        response.p99 = percentile(sorted, 0.99);
+    }
+
+private:
+
+    static constexpr std::size_t    capacity{1 << 16};      // the most recent requests
+
+    std::mutex                      lock;
+    std::vector<float>              samples;
+    std::size_t                     total{};
+};
+
+
+
+struct ServerOptions
+{
+    std::filesystem::path   socket;
+    std::filesystem::path   bank;           // gaussian sample bank,  generated if empty
+    std::filesystem::path   aimTable;       // optional,  for bestAim
+};
+
+void serve(ServerOptions const &options);
+
+
+struct LoadOptions
+{
+    std::filesystem::path   socket;
+    int                     connections;
+    int                     requests;       // per connection
+    int                     pipeline;       // outstanding requests per connection
+};
+
+void load(LoadOptions const &options);
+
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "print.h"
+#include "sockets.h"
+#include "query.h"
+
+
+namespace
+{
+
+constexpr float boardRadius{170};           // mm,  the outside of the double ring
+
+using Clock = std::chrono::steady_clock;
+
+
+Sockets::Socket connectTo(std::filesystem::path const &path)
+{
+    auto const s = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if(s == Sockets::invalid)
+    {
+        Sockets::throwError("socket");
+    }
+
+    auto const address = Sockets::unixAddress(path);
+
+    if(connect(s, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0)
+    {
+        Sockets::throwError("connect");
+    }
+
+    return s;
+}
+
+
+void exchange(Sockets::Socket s, void *data, int size, bool sending)
+{
+    auto bytes = static_cast<char*>(data);
+
+    while(size)
+    {
+        auto const done = sending ? send(s, bytes, size, 0)
+                                  : recv(s, bytes, size, 0);
+
+        if(done <= 0)
+        {
+            Sockets::throwError(sending ? "send" : "recv");
+        }
+
+        bytes += done;
+        size  -= done;
+    }
+}
+
+
+Query::Request randomRequest(std::mt19937 &rng, std::uint32_t id)
+{
+    std::uniform_real_distribution<float>   unit    {  -1,   1};
+    std::uniform_real_distribution<float>   sigma   {   5,  50};
+    std::uniform_real_distribution<float>   rho     {-0.5, 0.5};
+    std::uniform_int_distribution<>         percent {   0,  99};
+
+    auto const kind = percent(rng) < 90 ? Query::Kind::expectedScore
+                                        : Query::Kind::bestAim;
+
+    float x, y;
+
+    do                                                              // evenly over the board
+    {
+        x = unit(rng);
+        y = unit(rng);
+    }
+    while(x*x + y*y > 1);
+
+    return {id, kind, boardRadius * x, boardRadius * y, sigma(rng), sigma(rng), rho(rng), 0};
+}
+
+
+struct ConnectionResult
+{
+    std::vector<float>  latencies;          // microseconds per ok request
+    int                 failed{};           // requests answered with another status
+};
+
+
+ConnectionResult connectionLoad(Query::LoadOptions const &options, int connection)
+{
+    auto const                      s = connectTo(options.socket);
+    std::mt19937                    rng{ static_cast<std::uint32_t>(connection)};
+    std::vector<Clock::time_point>  sent(options.requests);
+    ConnectionResult                result;
+
+    result.latencies.reserve(options.requests);
+
+    int next{};
+
+    auto sendOne = [&]
+    {
+        auto request = randomRequest(rng, next);
+
+        sent[next++] = Clock::now();
+        exchange(s, &request, sizeof(request), true);
+    };
+
+    while(next < (std::min)(options.pipeline, options.requests))
+    {
+        sendOne();
+    }
+
+    for(int received=0; received < options.requests; received++)
+    {
+        Query::Response response{};
+
+        exchange(s, &response, sizeof(response), false);
+
+        if(response.id >= sent.size())
+        {
+            throw std::runtime_error{"response to a request that wasn't sent"};
+        }
+
+        if(response.status == Query::Status::ok)
+        {
+            result.latencies.push_back(std::chrono::duration<float,std::micro>{Clock::now() - sent[response.id]}.count());
+        }
+        else
+        {
+            result.failed++;
+        }
+
+        if(next < options.requests)
+        {
+            sendOne();
+        }
+    }
+
+    Sockets::close(s);
+
+    return result;
+}
+
+}
+
+
+
+void Query::load(LoadOptions const &options)
+{
+    Sockets::startup();
+
+    std::vector<ConnectionResult>   perConnection(options.connections);
+
+    auto const start = Clock::now();
+    {
+        std::vector<std::jthread>   clients;
+
+        for(int c=0;c<options.connections;c++)
+        {
+            clients.emplace_back([&,c]
+            {
+                try
+                {
+                    perConnection[c] = connectionLoad(options, c);
+                }
+                catch(std::exception const &e)
+                {
+                    print("connection {} : {}\n", c, e.what());
+                }
+            });
+        }
+    }
+    std::chrono::duration<double> const elapsed{Clock::now() - start};
+
+    std::vector<float>  all;
+    int                 failed{};
+
+    for(auto const &result : perConnection)
+    {
+        all.insert(all.end(), result.latencies.begin(), result.latencies.end());
+        failed += result.failed;
+    }
+
+    std::sort(all.begin(), all.end());
+
+    print("client : {} requests in {:.2f}s ({:.0f}/s)   p50 {:.1f}us   p90 {:.1f}us   p99 {:.1f}us   {} failed\n",
+          all.size(), elapsed.count(), all.size() / elapsed.count(), percentile(all, 0.50), percentile(all, 0.90), percentile(all, 0.99), failed);
+
+
+    auto const  s = connectTo(options.socket);
+    Request     request{0, Kind::stats};
+    Response    stats{};
+
+    exchange(s, &request, sizeof(request), true);
+    exchange(s, &stats,   sizeof(stats),   false);
+
+    Sockets::close(s);
+
+    print("server : {} requests                 p50 {:.1f}us   p90 {:.1f}us   p99 {:.1f}us\n",
+          stats.count, stats.p50, stats.p90, stats.p99);
+}
@@ -0,0 +1,498 @@
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "print.h"
+#include "sockets.h"
+#include "query.h"
+#include "sampleBank.h"
+#include "scoreField.h"
+#include "sweep.h"
+
+
+namespace
+{
+
+constexpr std::size_t   maxBatch        {256};
+constexpr std::size_t   maxOutbox       {1 << 16};      // responses waiting for a client that isn't reading,  before it is dropped
+constexpr std::size_t   serverDarts     {4096};
+constexpr std::uint64_t serverSeed      {1};
+constexpr int           serverResolution{4};            // score field cells per mm
+constexpr float         maxPosition     {1e4f};         // mm.  Aiming off the board is allowed,  this only keeps the scoring in range
+constexpr auto          reportEvery     {std::chrono::seconds{10}};
+
+using Clock = std::chrono::steady_clock;
+
+
+bool receiveAll(Sockets::Socket s, void *data, int size)
+{
+    auto bytes = static_cast<char*>(data);
+
+    while(size)
+    {
+        auto const received = recv(s, bytes, size, 0);
+
+        if(received <= 0)
+        {
+            return false;
+        }
+
+        bytes += received;
+        size  -= received;
+    }
+
+    return true;
+}
+
+
+bool sendAll(Sockets::Socket s, void const *data, int size)
+{
+    auto bytes = static_cast<char const*>(data);
+
+    while(size)
+    {
+        auto const sent = send(s, bytes, size, 0);
+
+        if(sent <= 0)
+        {
+            return false;
+        }
+
+        bytes += sent;
+        size  -= sent;
+    }
+
+    return true;
+}
+
+
+
+/*
+
+    Each connection has a reader thread,  which queues its requests,  and a writer
+    thread,  which sends the replies the evaluator leaves in its outbox.  So a
+    client that stops reading only backs up its own outbox,  never the evaluator;
+    if the outbox grows past maxOutbox the connection is shut down.
+
+*/
+
+class Connection
+{
+public:
+
+    explicit Connection(Sockets::Socket socket) : socket{socket}
+    {
+    }
+
+    ~Connection()
+    {
+        Sockets::close(socket);
+    }
+
+    Sockets::Socket socket;
+
+
+    void expect()                                                   // a request has been queued
+    {
+        std::lock_guard guard{lock};
+
+        inFlight++;
+    }
+
+
+    void reply(std::vector<Query::Response> const &responses)
+    {
+        {
+            std::lock_guard guard{lock};
+
+            inFlight -= responses.size();
+
+            if(!broken)
+            {
+                if(outbox.size() + responses.size() > maxOutbox)
+                {
+                    breakLocked();
+                }
+                else
+                {
+                    outbox.insert(outbox.end(), responses.begin(), responses.end());
+                }
+            }
+        }
+
+        ready.notify_one();
+    }
+
+
+    void finish()                                                   // the client has stopped sending
+    {
+        {
+            std::lock_guard guard{lock};
+
+            reading = false;
+        }
+
+        ready.notify_one();
+    }
+
+
+    void writeLoop()                                                // until the reader has finished and every reply is sent
+    {
+        std::vector<Query::Response>    sending;
+
+        for(;;)
+        {
+            {
+                std::unique_lock    guard{lock};
+
+                ready.wait(guard, [&]{ return !outbox.empty() || (!reading && inFlight == 0); });
+
+                if(outbox.empty())
+                {
+                    return;
+                }
+
+                sending.swap(outbox);
+            }
+
+            if(!sendAll(socket, sending.data(), static_cast<int>(sending.size() * sizeof(Query::Response))))
+            {
+                std::lock_guard guard{lock};
+
+                breakLocked();
+            }
+
+            sending.clear();
+        }
+    }
+
+private:
+
+    void breakLocked()
+    {
+        broken = true;
+        outbox.clear();
+        shutdown(socket, Sockets::shutdownBoth);                    // so the reader's recv fails too
+    }
+
+
+    std::mutex                      lock;
+    std::condition_variable         ready;
+    std::vector<Query::Response>    outbox;
+    std::size_t                     inFlight{};
+    bool                            reading{true};
+    bool                            broken{};
+};
+
+
+struct Pending
+{
+    Query::Request                  request;
+    std::shared_ptr<Connection>     connection;
+    Clock::time_point               arrived;
+};
+
+
+class Queue
+{
+public:
+
+    void push(Pending pending)
+    {
+        {
+            std::lock_guard guard{lock};
+            queue.push_back(std::move(pending));
+        }
+
+        ready.notify_one();
+    }
+
+
+    std::vector<Pending> take(std::size_t most, Clock::duration timeout)     // everything waiting,  up to most
+    {
+        std::unique_lock    guard{lock};
+
+        ready.wait_for(guard, timeout, [&]{ return !queue.empty(); });
+
+        auto const count = (std::min)(most, queue.size());
+
+        std::vector<Pending>    batch(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.begin() + count));
+
+        queue.erase(queue.begin(), queue.begin() + count);
+
+        return batch;
+    }
+
+private:
+
+    std::mutex                  lock;
+    std::condition_variable     ready;
+    std::vector<Pending>        queue;
+};
+
+
+
+class Evaluator
+{
+public:
+
+    explicit Evaluator(Query::ServerOptions const &options) : field{serverResolution}
+    {
+        bank = options.bank.empty() ? Darts::SampleBank{Darts::Generator::gaussian, serverSeed, serverDarts}
+                                    : Darts::SampleBank::load(options.bank);
+
+        if(bank.header().generator != Darts::Generator::gaussian)
+        {
+            throw std::invalid_argument{"the server needs a gaussian sample bank"};
+        }
+
+        if(!options.aimTable.empty())
+        {
+            aims = AimTable::load(options.aimTable);
+        }
+
+        print("serving with {} darts{}\n", bank.header().count, aims ? ", aim table loaded" : "");
+    }
+
+
+    void evaluate(std::vector<Pending> const &batch, std::vector<Query::Response> &responses, Query::Latencies &latencies)
+    {
+        responses.assign(batch.size(), Query::Response{});
+
+        std::vector<std::size_t>    scored;
+
+        for(std::size_t i=0;i<batch.size();i++)
+        {
+            auto const &request  = batch[i].request;
+            auto       &response = responses[i];
+
+            response.id = request.id;
+
+            if(   request.kind != Query::Kind::stats
+               && !(   request.sigmaX >= 0 && request.sigmaX < 1000
+                    && request.sigmaY >= 0 && request.sigmaY < 1000
+                    && std::abs(request.rho) < 1))
+            {
+                response.status = Query::Status::badRequest;
+                continue;
+            }
+
+            if(   request.kind == Query::Kind::expectedScore
+               && !(   std::abs(request.x) < maxPosition                  // false for NaN too
+                    && std::abs(request.y) < maxPosition))
+            {
+                response.status = Query::Status::badRequest;
+                continue;
+            }
+
+            switch(request.kind)
+            {
+            case Query::Kind::expectedScore:
+                scored.push_back(i);
+                break;
+
+            case Query::Kind::bestAim:
+                if(aims)
+                {
+                    auto const aim = aims->recommend({request.sigmaX, request.sigmaY, request.rho, 0, 0});
+
+                    response.x        = aim.x;
+                    response.y        = aim.y;
+                    response.expected = aim.expected;
+                }
+                else
+                {
+                    response.status = Query::Status::unavailable;
+                }
+                break;
+
+            case Query::Kind::stats:
+                latencies.fill(response);
+                break;
+
+            default:
+                response.status = Query::Status::badRequest;
+                break;
+            }
+        }
+
+        expectedScores(batch, scored, responses);
+    }
+
+private:
+
+    // All the expectedScore requests of a batch share one pass over the darts;  the
+    // inner loop runs across requests on structure-of-arrays copies of their parameters.
+
+    void expectedScores(std::vector<Pending> const &batch, std::vector<std::size_t> const &scored, std::vector<Query::Response> &responses)
+    {
+        auto const n = scored.size();
+
+        if(n == 0)
+        {
+            return;
+        }
+
+        std::vector<float>  x(n), y(n), sigmaX(n), sigmaY(n), rho(n), shear(n);
+        std::vector<int>    total(n);
+
+        for(std::size_t b=0;b<n;b++)
+        {
+            auto const &request = batch[scored[b]].request;
+
+            x[b]      = request.x;
+            y[b]      = request.y;
+            sigmaX[b] = request.sigmaX;
+            sigmaY[b] = request.sigmaY;
+            rho[b]    = request.rho;
+            shear[b]  = std::sqrt(1 - request.rho * request.rho);
+        }
+
+        auto const darts = bank.view();
+
+        for(std::size_t i=0;i<darts.size();i++)
+        {
+            auto const z1 = darts.x[i] / Darts::gaussianSigma;
+            auto const z2 = darts.y[i] / Darts::gaussianSigma;
+
+            for(std::size_t b=0;b<n;b++)
+            {
+                total[b] += field.score(x[b] + sigmaX[b] * z1,
+                                        y[b] + sigmaY[b] * (rho[b] * z1 + shear[b] * z2));
+            }
+        }
+
+        for(std::size_t b=0;b<n;b++)
+        {
+            auto &response = responses[scored[b]];
+
+            response.x        = x[b];
+            response.y        = y[b];
+            response.expected = static_cast<float>(total[b]) / darts.size();
+        }
+    }
+
+
+    ScoreField              field;
+    Darts::SampleBank       bank;
+    std::optional<AimTable> aims;
+};
+
+
+
+void evaluateLoop(std::stop_token stop, Evaluator &evaluator, Queue &queue, Query::Latencies &latencies)
+{
+    std::vector<Query::Response>    responses;
+    auto                            lastReport{Clock::now()};
+
+    while(!stop.stop_requested())
+    {
+        auto const batch = queue.take(maxBatch, reportEvery);
+
+        evaluator.evaluate(batch, responses, latencies);
+
+        std::map<Connection*, std::vector<Query::Response>>   replies;        // one hand-over per connection per batch
+
+        for(std::size_t i=0;i<batch.size();i++)
+        {
+            replies[batch[i].connection.get()].push_back(responses[i]);
+        }
+
+        for(auto &[connection, reply] : replies)
+        {
+            connection->reply(reply);
+        }
+
+        auto const now = Clock::now();
+
+        for(auto const &pending : batch)
+        {
+            latencies.record(std::chrono::duration<float,std::micro>{now - pending.arrived}.count());
+        }
+
+        if(now - lastReport >= reportEvery)
+        {
+            Query::Response stats{};
+
+            latencies.fill(stats);
+            print("served {:8}   p50 {:7.1f}us   p90 {:7.1f}us   p99 {:7.1f}us\n", stats.count, stats.p50, stats.p90, stats.p99);
+
+            lastReport = now;
+        }
+    }
+}
+
+
+void readLoop(std::shared_ptr<Connection> connection, Queue &queue)
+{
+    Query::Request  request{};
+
+    while(receiveAll(connection->socket, &request, sizeof(request)))
+    {
+        connection->expect();
+        queue.push({request, connection, Clock::now()});
+    }
+
+    connection->finish();
+}
+
+
+void writeLoop(std::shared_ptr<Connection> connection)
+{
+    connection->writeLoop();
+}
+
+}
+
+
+
+void Query::serve(ServerOptions const &options)
+{
+    Sockets::startup();
+
+    Evaluator   evaluator{options};
+    Queue       queue;
+    Latencies   latencies;
+
+    auto const listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if(listener == Sockets::invalid)
+    {
+        Sockets::throwError("socket");
+    }
+
+    auto const address = Sockets::unixAddress(options.socket);
+
+    std::filesystem::remove(options.socket);
+
+    if(   bind  (listener, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0
+       || listen(listener, SOMAXCONN) != 0)
+    {
+        Sockets::throwError("bind");
+    }
+
+    print("listening on {}\n", options.socket.string());
+
+    std::jthread    evaluatorThread{ [&](std::stop_token stop){ evaluateLoop(stop, evaluator, queue, latencies); } };
+
+    for(;;)
+    {
+        auto const client = accept(listener, nullptr, nullptr);
+
+        if(client == Sockets::invalid)
+        {
+            Sockets::throwError("accept");
+        }
+
+        auto connection = std::make_shared<Connection>(client);
+
+        std::thread{writeLoop, connection}.detach();
+        std::thread{readLoop,  connection, std::ref(queue)}.detach();
+    }
+}
@@ -13,6 +13,9 @@
 #define IDC_EXPECTED_SCORE              1006
 #define IDC_BUTTON1                     1007
 #define IDC_FINDBEST                    1007
+#define IDC_OBJECTIVE                   1008
+#define IDC_OBJECTIVE_PARAM             1009
+#define IDC_OPTIMIZE                    1010
 
 // Next default values for new objects
 // 
@@ -20,7 +23,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        103
 #define _APS_NEXT_COMMAND_VALUE         40001
-#define _APS_NEXT_CONTROL_VALUE         1008
+#define _APS_NEXT_CONTROL_VALUE         1011
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+
+/*
+
+    xoshiro256+  (Blackman & Vigna)  run as LANES independent generators side by side.
+
+    The state is stored lane-major so that one step is the same handful of
+    shifts, xors and adds applied to LANES adjacent 64-bit words;  the compiler
+    turns the loops below into vector instructions.
+
+    Every (seed,stream) pair gives an independent, reproducible sequence - each
+    lane is seeded by splitmix64 from seed, stream and lane number.
+
+*/
+
+
+namespace Rng
+{
+
+constexpr std::size_t   lanes{8};
+
+
+constexpr std::uint64_t splitmix64(std::uint64_t &state)
+{
+    auto z = (state += 0x9e3779b97f4a7c15);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+
+    return z ^ (z >> 31);
+}
+
+
+class Xoshiro
+{
+public:
+
+    using Block = std::array<float, lanes>;
+
+    Xoshiro(std::uint64_t seed, std::uint64_t stream)
+    {
+        for(std::size_t lane=0;lane<lanes;lane++)
+        {
+            std::uint64_t mix{ seed ^ splitmix64(stream) ^ (lane * 0xd1b54a32d192ed03) };
+
+            s0[lane] = splitmix64(mix);
+            s1[lane] = splitmix64(mix);
+            s2[lane] = splitmix64(mix);
+            s3[lane] = splitmix64(mix);
+        }
+    }
+
+
+    void uniform(Block &out)        // [0,1)
+    {
+        for(std::size_t lane=0;lane<lanes;lane++)
+        {
+            auto const result = s0[lane] + s3[lane];
+            auto const t      = s1[lane] << 17;
+
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane]  = (s3[lane] << 45) | (s3[lane] >> 19);
+
+            out[lane] = static_cast<float>(result >> 40) * 0x1.0p-24f;     // top 24 bits are the best ones
+        }
+    }
+
+private:
+
+    alignas(64) std::array<std::uint64_t, lanes>   s0;
+    alignas(64) std::array<std::uint64_t, lanes>   s1;
+    alignas(64) std::array<std::uint64_t, lanes>   s2;
+    alignas(64) std::array<std::uint64_t, lanes>   s3;
+};
+
+}
@@ -0,0 +1,247 @@
+#include <Windows.h>
+
+#include <cstring>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "print.h"
+#include "win32.h"
+#include "sampleBank.h"
+
+
+namespace
+{
+
+auto alignUp(std::size_t bytes)
+{
+    return (bytes + Darts::bankAlign - 1) & ~(Darts::bankAlign - 1);
+}
+
+}
+
+
+namespace Darts
+{
+
+SampleBank bank;
+
+
+SampleBank::SampleBank(Generator generator, std::uint64_t seed, std::size_t count)
+{
+    auto const xOffset  = sizeof(BankHeader);
+    auto const yOffset  = xOffset + alignUp(count * sizeof(float));
+
+    imageSize = yOffset + alignUp(count * sizeof(float));
+
+    auto memory = static_cast<std::byte*>(::operator new(imageSize, std::align_val_t{bankAlign}));
+
+    image.reset(memory, [](std::byte *p){ ::operator delete(p, std::align_val_t{bankAlign}); });
+
+    std::memset(memory, 0, imageSize);
+
+    auto const x = reinterpret_cast<float*>(memory + xOffset);
+    auto const y = reinterpret_cast<float*>(memory + yOffset);
+
+    generateDarts(generator, seed, {x, count}, {y, count});
+
+    BankHeader header
+    {
+        bankMagic,
+        bankVersion,
+        generator,
+        seed,
+        count,
+        0,
+        xOffset,
+        yOffset,
+        0,
+    };
+
+    std::memcpy(memory, &header, sizeof(header));
+
+    header.hash = hashDarts(view());
+
+    std::memcpy(memory, &header, sizeof(header));
+}
+
+
+SampleBank SampleBank::load(std::filesystem::path const &path)
+{
+    Handle file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)};
+
+    if(file.h == INVALID_HANDLE_VALUE)
+    {
+        throwLastError("CreateFile");
+    }
+
+    LARGE_INTEGER size{};
+
+    if(!GetFileSizeEx(file.h, &size))
+    {
+        throwLastError("GetFileSizeEx");
+    }
+
+    if(size.QuadPart < static_cast<LONGLONG>(sizeof(BankHeader)))
+    {
+        throw std::runtime_error{"sample bank : truncated header"};
+    }
+
+    Handle mapping{ CreateFileMappingW(file.h, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+
+    if(mapping.h == nullptr)
+    {
+        throwLastError("CreateFileMapping");
+    }
+
+    auto view = static_cast<std::byte*>(MapViewOfFile(mapping.h, FILE_MAP_READ, 0, 0, 0));
+
+    if(view == nullptr)
+    {
+        throwLastError("MapViewOfFile");
+    }
+
+    SampleBank  result;
+
+    result.image.reset(view, [](std::byte *p){ UnmapViewOfFile(p); });
+    result.imageSize = static_cast<std::size_t>(size.QuadPart);
+
+    auto const &header = result.header();
+
+    if(   header.magic   != bankMagic
+       || header.version != bankVersion)
+    {
+        throw std::runtime_error{"sample bank : not a version " + std::to_string(bankVersion) + " bank"};
+    }
+
+    if(static_cast<std::uint32_t>(header.generator) >= generators)
+    {
+        throw std::runtime_error{"sample bank : unknown generator"};
+    }
+
+    if(   header.xOffset % bankAlign != 0                                      // each test bounds the next,  so none of them overflows
+       || header.yOffset % bankAlign != 0
+       || header.xOffset < sizeof(BankHeader)
+       || header.xOffset > result.imageSize
+       || header.count   > (result.imageSize - header.xOffset) / sizeof(float)
+       || header.yOffset < header.xOffset + header.count * sizeof(float)
+       || header.yOffset > result.imageSize
+       || header.count   > (result.imageSize - header.yOffset) / sizeof(float))
+    {
+        throw std::runtime_error{"sample bank : bad layout"};
+    }
+
+    if(hashDarts(result.view()) != header.hash)
+    {
+        throw std::runtime_error{"sample bank : content hash mismatch"};
+    }
+
+    return result;
+}
+
+
+void SampleBank::save(std::filesystem::path const &path) const
+{
+    Handle file{ CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr)};
+
+    if(file.h == INVALID_HANDLE_VALUE)
+    {
+        throwLastError("CreateFile");
+    }
+
+    auto        data      = image.get();
+    std::size_t remaining = imageSize;
+
+    while(remaining)
+    {
+        auto  chunk   = static_cast<DWORD>(std::min<std::size_t>(remaining, 1 << 30));
+        DWORD written{};
+
+        if(!WriteFile(file.h, data, chunk, &written, nullptr))
+        {
+            throwLastError("WriteFile");
+        }
+
+        data      += written;
+        remaining -= written;
+    }
+}
+
+
+BankView SampleBank::view() const
+{
+    if(!image)
+    {
+        return {};
+    }
+
+    auto const &header = this->header();
+    auto const  count  = static_cast<std::size_t>(header.count);
+
+    return BankView
+    {
+        { reinterpret_cast<float const*>(image.get() + header.xOffset), count },
+        { reinterpret_cast<float const*>(image.get() + header.yOffset), count },
+    };
+}
+
+
+std::uint64_t hashDarts(BankView const &darts)
+{
+    std::uint64_t hash{0xcbf29ce484222325};
+
+    auto fnv = [&](std::span<float const> values)
+    {
+        for(auto byte : std::as_bytes(values))
+        {
+            hash ^= static_cast<std::uint8_t>(byte);
+            hash *= 0x100000001b3;
+        }
+    };
+
+    fnv(darts.x);
+    fnv(darts.y);
+
+    return hash;
+}
+
+
+SampleBank openBank(std::filesystem::path const &path, Generator generator, std::size_t count)
+{
+    if(std::filesystem::exists(path))
+    {
+        try
+        {
+            auto bank = SampleBank::load(path);
+
+            print("sample bank {} : {} darts, generator {}, seed {:#x}\n",
+                  path.string(), bank.header().count, static_cast<int>(bank.header().generator), bank.header().seed);
+
+            return bank;
+        }
+        catch(std::exception const &e)
+        {
+            print("sample bank {} : {},  regenerating it\n", path.string(), e.what());
+        }
+    }
+
+    std::uint64_t const seed{ (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}() };
+
+    SampleBank  bank{generator, seed, count};
+
+    print("sample bank {} : generated {} darts, seed {:#x}\n", path.string(), count, seed);
+
+    try
+    {
+        bank.save(path);
+    }
+    catch(std::exception const &e)
+    {
+        print("sample bank {} : not saved,  {}\n", path.string(), e.what());       // still usable for this run
+    }
+
+    return bank;
+}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <span>
+#include <memory>
+#include <filesystem>
+
+
+/*
+
+    Sample bank file layout  (little-endian)
+
+        0       BankHeader          64 bytes
+        xOffset float X[count]      64-byte aligned
+        yOffset float Y[count]      64-byte aligned
+
+    X and Y are offsets from the aim-point,  +y is down the board.  The disc and
+    circle generators stay within the unit disc (-1.0 -> 1.0);  gaussian banks are
+    standard normals scaled by gaussianSigma,  so they are unbounded;  about 1
+    dart in 650 lands more than 1.8 from the aim-point.
+
+    Version 2 banks come from the xoshiro generators.  Version 1 banks,  from the
+    earlier mt19937 ones,  aren't loaded,  since their (generator, seed) no longer
+    reproduces their darts.
+
+*/
+
+
+namespace Darts
+{
+
+enum class Generator : std::uint32_t
+{
+    uniformDisc,            // evenly spread over the disc
+    circle,                 // uniform radius,  so concentrated towards the aim-point
+    lowerCircle,            // as circle, but only below the aim-point
+    realistic,              // uniform radius,  angle mainly below the aim-point
+    gaussian,               // circular normal,  sigma = gaussianSigma
+};
+
+constexpr std::uint32_t generators{static_cast<std::uint32_t>(Generator::gaussian) + 1};
+
+
+constexpr float         gaussianSigma   {0.5f};
+constexpr std::size_t   generateChunk   {1 << 16};     // darts per RNG stream,  the unit of parallel work
+
+
+constexpr std::array<char,8>    bankMagic   {'D','A','R','T','B','A','N','K'};
+constexpr std::uint32_t         bankVersion {2};
+constexpr std::size_t           bankAlign   {64};
+
+
+struct BankHeader
+{
+    std::array<char,8>  magic;
+    std::uint32_t       version;
+    Generator           generator;
+    std::uint64_t       seed;
+    std::uint64_t       count;
+    std::uint64_t       hash;           // FNV-1a of X[] then Y[]
+    std::uint64_t       xOffset;        // bytes from start of file
+    std::uint64_t       yOffset;
+    std::uint64_t       reserved;
+};
+
+static_assert(sizeof(BankHeader) == bankAlign);
+
+
+struct BankView
+{
+    std::span<float const>  x;
+    std::span<float const>  y;
+
+    std::size_t size() const
+    {
+        return x.size();
+    }
+};
+
+
+class SampleBank
+{
+public:
+
+    SampleBank() = default;
+    SampleBank(Generator generator, std::uint64_t seed, std::size_t count);
+
+    static SampleBank load(std::filesystem::path const &path);              // memory-mapped, read-only
+    void              save(std::filesystem::path const &path) const;
+
+    BankHeader const &header() const
+    {
+        return *reinterpret_cast<BankHeader const*>(image.get());
+    }
+
+    BankView          view() const;
+
+private:
+
+    std::shared_ptr<std::byte>  image;          // header followed by X[] and Y[],  heap or mapped file
+    std::size_t                 imageSize{};
+};
+
+
+void            generateDarts(Generator generator, std::uint64_t seed, std::span<float> x, std::span<float> y);     // multi-threaded, same result for any thread count
+std::uint64_t   hashDarts(BankView const &darts);
+
+SampleBank      openBank(std::filesystem::path const &path, Generator generator, std::size_t count);    // load, or generate and save if it is missing or unusable
+
+extern SampleBank bank;
+
+}
@@ -0,0 +1,36 @@
+#include <cmath>
+
+#include "dimensions.h"
+#include "window.h"
+#include "outcome.h"
+#include "scoreField.h"
+
+
+ScoreField::ScoreField(int cellsPerMm) : cellsPerMm{cellsPerMm}
+{
+    centre = static_cast<int>(std::ceil(Board::Radius::board * cellsPerMm)) + 1;
+    side   = 2 * centre + 1;
+
+    cells.resize(static_cast<std::size_t>(side) * side);
+
+    auto const board = boardDimensions({0,0}, static_cast<int>(Board::Radius::board * cellsPerMm));
+
+    static_assert(std::tuple_size_v<decltype(points)> == Bed::count + 1);
+
+    points[0] = 0;
+
+    for(int bed=0;bed<Bed::count;bed++)
+    {
+        points[bed+1] = static_cast<std::uint8_t>(Bed::points(bed));
+    }
+
+    for(int row=0;row<side;row++)
+    {
+        for(int column=0;column<side;column++)
+        {
+            auto const bed = Bed::index(scoreFromPoint(board, column-centre, row-centre));
+
+            cells[row * side + column] = static_cast<std::uint8_t>(bed + 1);
+        }
+    }
+}
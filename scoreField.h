@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+
+
+/*
+
+    The board rasterised once by scoreFromPoint,  so that a dart can be scored
+    with a single table lookup.
+
+    Each cell holds Bed::index+1,  0 for a miss.
+
+    Coordinates are millimetres from the centre of the board,  +y is down.
+
+*/
+
+
+class ScoreField
+{
+public:
+
+    explicit ScoreField(int cellsPerMm);
+
+    int bed(float x, float y) const                 // Bed::index,  -1 off the board
+    {
+        return cell(x,y) - 1;
+    }
+
+    int score(float x, float y) const               // score*multiplier,  0 off the board
+    {
+        return points[cell(x,y)];
+    }
+
+    int resolution() const
+    {
+        return cellsPerMm;
+    }
+
+private:
+
+    int cell(float x, float y) const
+    {
+        auto const column = static_cast<int>(x * cellsPerMm + centre + 0.5f);
+        auto const row    = static_cast<int>(y * cellsPerMm + centre + 0.5f);
+
+        if(   static_cast<unsigned>(column) >= static_cast<unsigned>(side)
+           || static_cast<unsigned>(row)    >= static_cast<unsigned>(side))
+        {
+            return 0;
+        }
+
+        return cells[row * side + column];
+    }
+
+
+    int                         cellsPerMm;
+    int                         centre;
+    int                         side;
+    std::vector<std::uint8_t>   cells;          // row major
+    std::array<std::uint8_t,63> points;         // by cell value
+};
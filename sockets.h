@@ -0,0 +1,112 @@
+#pragma once
+
+#ifdef _WIN32
+
+#include <WinSock2.h>
+#include <afunix.h>
+
+#pragma comment(lib,"ws2_32")
+
+#else
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <csignal>
+
+#endif
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+
+/*
+
+    The little of Winsock and POSIX sockets the query server and client use,
+    so that they don't depend on which one they're built against.
+
+*/
+
+
+namespace Sockets
+{
+
+#ifdef _WIN32
+
+using Socket = SOCKET;
+
+constexpr Socket    invalid     {INVALID_SOCKET};
+constexpr int       shutdownBoth{SD_BOTH};
+
+inline int lastError()
+{
+    return WSAGetLastError();
+}
+
+inline void close(Socket s)
+{
+    closesocket(s);
+}
+
+#else
+
+using Socket = int;
+
+constexpr Socket    invalid     {-1};
+constexpr int       shutdownBoth{SHUT_RDWR};
+
+inline int lastError()
+{
+    return errno;
+}
+
+inline void close(Socket s)
+{
+    ::close(s);
+}
+
+#endif
+
+
+[[noreturn]] inline void throwError(char const *what)
+{
+    throw std::system_error{ lastError(), std::system_category(), what};
+}
+
+
+inline void startup()                               // once,  before any other call
+{
+#ifdef _WIN32
+    WSADATA wsa{};
+
+    if(auto const error = WSAStartup(MAKEWORD(2,2), &wsa))
+    {
+        throw std::system_error{ error, std::system_category(), "WSAStartup"};
+    }
+#else
+    std::signal(SIGPIPE, SIG_IGN);                  // a peer that has gone fails the send,  rather than ending the process
+#endif
+}
+
+
+inline sockaddr_un unixAddress(std::filesystem::path const &path)
+{
+    auto const  name = path.string();
+    sockaddr_un address{};
+
+    if(name.size() >= sizeof(address.sun_path))
+    {
+        throw std::invalid_argument{"socket path too long : " + name};
+    }
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, name.c_str(), name.size() + 1);
+
+    return address;
+}
+
+}
@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+#include "print.h"
+#include "dimensions.h"
+#include "parallel.h"
+#include "sweep.h"
+
+
+namespace
+{
+
+constexpr std::array<char,8>    tableMagic      {'A','I','M','T','A','B','L','E'};
+constexpr std::uint32_t         tableVersion    {1};
+
+constexpr float                 coarseStep      {2.0f};         // mm
+constexpr float                 fineStep        {0.25f};
+constexpr int                   candidates      {4};            // coarse maxima that get refined
+constexpr float                 blendDistance   {10.0f};        // corner aims further apart than this are not interpolated
+
+constexpr auto                  checkpointEvery {std::chrono::seconds{10}};
+
+
+struct TableHeader
+{
+    std::array<char,8>  magic;
+    std::uint32_t       version;
+    SweepGrid           grid;
+    std::uint64_t       count;
+};
+
+
+float expected(ScoreField const &field, Scatter const &darts, float x, float y)
+{
+    int total{};
+
+    for(std::size_t i=0;i<darts.x.size();i++)
+    {
+        total += field.score(x + darts.x[i], y + darts.y[i]);
+    }
+
+    return static_cast<float>(total) / darts.x.size();
+}
+
+}
+
+
+
+Scatter scatter(Darts::BankView const &normals, ScatterModel const &model)
+{
+    Scatter     darts{ std::vector<float>(normals.size()), std::vector<float>(normals.size())};
+
+    auto const  shear = std::sqrt(1 - model.rho * model.rho);
+
+    for(std::size_t i=0;i<normals.size();i++)
+    {
+        auto const z1 = normals.x[i] / Darts::gaussianSigma;
+        auto const z2 = normals.y[i] / Darts::gaussianSigma;
+
+        darts.x[i] = model.biasX + model.sigmaX * z1;
+        darts.y[i] = model.biasY + model.sigmaY * (model.rho * z1 + shear * z2);
+    }
+
+    return darts;
+}
+
+
+
+ScatterModel SweepGrid::model(std::size_t index) const
+{
+    auto const k = static_cast<std::uint32_t>(index % rho.steps);
+    index /= rho.steps;
+
+    auto const j = static_cast<std::uint32_t>(index % sigmaY.steps);
+    index /= sigmaY.steps;
+
+    auto const i = static_cast<std::uint32_t>(index);
+
+    return { sigmaX.value(i), sigmaY.value(j), rho.value(k), 0, 0};
+}
+
+
+
+AimTable::AimTable(SweepGrid const &grid) : sweepGrid{grid}, cells(grid.size(), Aim{0, 0, std::numeric_limits<float>::quiet_NaN()})
+{
+}
+
+
+AimTable AimTable::load(std::filesystem::path const &path)
+{
+    std::ifstream   file{path, std::ios::binary};
+    TableHeader     header{};
+
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        throw std::runtime_error{"aim table : truncated header"};
+    }
+
+    if(   header.magic   != tableMagic
+       || header.version != tableVersion
+       || header.count   != header.grid.size())
+    {
+        throw std::runtime_error{"aim table : not a version 1 table"};
+    }
+
+    AimTable    table{header.grid};
+
+    if(!file.read(reinterpret_cast<char*>(table.cells.data()), table.cells.size() * sizeof(Aim)))
+    {
+        throw std::runtime_error{"aim table : truncated"};
+    }
+
+    return table;
+}
+
+
+void AimTable::save(std::filesystem::path const &path) const
+{
+    auto temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream   file{temporary, std::ios::binary};
+        TableHeader     header{tableMagic, tableVersion, sweepGrid, cells.size()};
+
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.write(reinterpret_cast<char const*>(cells.data()), cells.size() * sizeof(Aim));
+
+        if(!file)
+        {
+            throw std::runtime_error{"aim table : write failed " + temporary.string()};
+        }
+    }
+
+    std::filesystem::rename(temporary, path);
+}
+
+
+bool AimTable::done(std::size_t index) const
+{
+    return !std::isnan(cells[index].expected);
+}
+
+
+Aim AimTable::recommend(ScatterModel const &player) const
+{
+    struct Position
+    {
+        std::uint32_t   below;
+        float           fraction;
+    };
+
+    auto locate = [](SweepAxis const &axis, float value)
+    {
+        if(axis.steps < 2)
+        {
+            return Position{0, 0};
+        }
+
+        auto const t     = std::clamp((value - axis.first) / (axis.last - axis.first), 0.0f, 1.0f) * (axis.steps - 1);
+        auto const below = (std::min)(static_cast<std::uint32_t>(t), axis.steps - 2);
+
+        return Position{below, t - below};
+    };
+
+    Position const  position[3]
+    {
+        locate(sweepGrid.sigmaX, player.sigmaX),
+        locate(sweepGrid.sigmaY, player.sigmaY),
+        locate(sweepGrid.rho,    player.rho),
+    };
+
+    std::uint32_t const steps[3]{ sweepGrid.sigmaX.steps, sweepGrid.sigmaY.steps, sweepGrid.rho.steps };
+
+    Aim     blend{};
+    Aim     nearest{};
+    float   nearestWeight{-1};
+    float   minX{ 1e9f}, minY{ 1e9f};
+    float   maxX{-1e9f}, maxY{-1e9f};
+
+    for(int corner=0;corner<8;corner++)
+    {
+        std::size_t index{};
+        float       weight{1};
+
+        for(int axis=0;axis<3;axis++)
+        {
+            auto const upper = (corner >> axis) & 1;
+            auto const i     = (std::min)(position[axis].below + upper, steps[axis] - 1);
+
+            index   = index * steps[axis] + i;
+            weight *= upper ? position[axis].fraction : 1 - position[axis].fraction;
+        }
+
+        auto const &aim = cells[index];
+
+        blend.x        += weight * aim.x;
+        blend.y        += weight * aim.y;
+        blend.expected += weight * aim.expected;
+
+        minX = (std::min)(minX, aim.x);   maxX = (std::max)(maxX, aim.x);
+        minY = (std::min)(minY, aim.y);   maxY = (std::max)(maxY, aim.y);
+
+        if(weight > nearestWeight)
+        {
+            nearestWeight = weight;
+            nearest       = aim;
+        }
+    }
+
+    auto result = std::hypot(maxX - minX, maxY - minY) < blendDistance ? blend : nearest;       // don't average the treble 20 with the treble 19
+
+    result.x -= player.biasX;
+    result.y -= player.biasY;
+
+    return result;
+}
+
+
+
+Aim bestAim(ScoreField const &field, Darts::BankView const &normals, ScatterModel const &model)
+{
+    auto const  darts = scatter(normals, model);
+    auto const  limit = static_cast<float>(Board::Radius::board);
+
+    std::vector<Aim>    coarse;
+
+    for(float y=-limit; y<=limit; y+=coarseStep)
+    {
+        for(float x=-limit; x<=limit; x+=coarseStep)
+        {
+            if(std::hypot(x,y) <= limit)
+            {
+                coarse.push_back({x, y, expected(field, darts, x, y)});
+            }
+        }
+    }
+
+    auto const top = std::min<std::size_t>(candidates, coarse.size());
+
+    std::partial_sort(coarse.begin(), coarse.begin() + top, coarse.end(),
+                      [](Aim const &a, Aim const &b){ return a.expected > b.expected; });
+
+    Aim best{coarse.front()};
+
+    for(std::size_t c=0;c<top;c++)
+    {
+        for(float dy=-coarseStep; dy<=coarseStep; dy+=fineStep)
+        {
+            for(float dx=-coarseStep; dx<=coarseStep; dx+=fineStep)
+            {
+                auto const x     = coarse[c].x + dx;
+                auto const y     = coarse[c].y + dy;
+                auto const score = expected(field, darts, x, y);
+
+                if(score > best.expected)
+                {
+                    best = {x, y, score};
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+
+
+void sweep(AimTable &table, ScoreField const &field, Darts::BankView const &normals, std::filesystem::path const &checkpoint)
+{
+    std::vector<std::size_t>    todo;
+
+    for(std::size_t i=0;i<table.size();i++)
+    {
+        if(!table.done(i))
+        {
+            todo.push_back(i);
+        }
+    }
+
+    print("sweep : {} of {} cells to do\n", todo.size(), table.size());
+
+    std::mutex                  lock;
+    std::condition_variable     progress;
+    std::atomic<std::size_t>    next{};
+    std::size_t                 completed{};
+
+    auto worker = [&]
+    {
+        for(auto i = next++; i < todo.size(); i = next++)
+        {
+            auto const aim = bestAim(field, normals, table.grid().model(todo[i]));
+
+            std::lock_guard guard{lock};
+
+            table[todo[i]] = aim;
+            completed++;
+            progress.notify_one();
+        }
+    };
+
+    auto const          pool = startOnAllCores(worker);
+
+    std::unique_lock    guard{lock};
+
+    while(completed < todo.size())
+    {
+        progress.wait_for(guard, checkpointEvery, [&]{ return completed == todo.size(); });
+
+        auto const snapshot = table;
+        auto const count    = completed;
+
+        guard.unlock();
+
+        snapshot.save(checkpoint);
+        print("sweep {}/{}   \r", count, todo.size());
+
+        guard.lock();
+    }
+
+    print("sweep done        \n");
+}
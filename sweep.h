@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include "sampleBank.h"
+#include "scoreField.h"
+
+
+/*
+
+    Anisotropic gaussian scatter,  millimetres.
+
+    A dart aimed at (x,y) lands at (x,y) + bias + L z,  where z is a pair of
+    standard normals from a gaussian sample bank and L is the Cholesky factor of
+
+            | sigmaX²             rho sigmaX sigmaY |
+            | rho sigmaX sigmaY   sigmaY²           |
+
+    Bias only translates the pattern,  so the best aim for a biased player is the
+    best unbiased aim minus the bias.  It is applied at lookup rather than being
+    swept.
+
+*/
+
+
+struct ScatterModel
+{
+    float   sigmaX;
+    float   sigmaY;
+    float   rho;
+    float   biasX;
+    float   biasY;
+};
+
+
+struct Scatter                  // a model's dart offsets from the aim-point
+{
+    std::vector<float>  x;
+    std::vector<float>  y;
+};
+
+Scatter scatter(Darts::BankView const &normals, ScatterModel const &model);
+
+
+
+struct SweepAxis
+{
+    float           first;
+    float           last;
+    std::uint32_t   steps;
+
+    float value(std::uint32_t i) const
+    {
+        return steps > 1 ? first + (last-first) * i / (steps-1)
+                         : first;
+    }
+};
+
+
+struct SweepGrid
+{
+    SweepAxis   sigmaX;
+    SweepAxis   sigmaY;
+    SweepAxis   rho;
+
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(sigmaX.steps) * sigmaY.steps * rho.steps;
+    }
+
+    ScatterModel model(std::size_t index) const;
+};
+
+
+struct Aim
+{
+    float   x;
+    float   y;
+    float   expected;
+};
+
+
+
+class AimTable
+{
+public:
+
+    AimTable() = default;
+    explicit AimTable(SweepGrid const &grid);
+
+    static AimTable load(std::filesystem::path const &path);
+    void            save(std::filesystem::path const &path) const;      // written to a temporary, then renamed
+
+    SweepGrid const &grid() const
+    {
+        return sweepGrid;
+    }
+
+    std::size_t size() const
+    {
+        return cells.size();
+    }
+
+    Aim       &operator[](std::size_t index)        {  return cells[index]; }
+    Aim const &operator[](std::size_t index) const  {  return cells[index]; }
+
+    bool done(std::size_t index) const;
+
+    Aim recommend(ScatterModel const &player) const;
+
+private:
+
+    SweepGrid           sweepGrid{};
+    std::vector<Aim>    cells;          // rho fastest,  then sigmaY,  then sigmaX.   expected is NaN until swept
+};
+
+
+
+Aim  bestAim(ScoreField const &field, Darts::BankView const &normals, ScatterModel const &model);
+
+void sweep(AimTable &table, ScoreField const &field, Darts::BankView const &normals, std::filesystem::path const &checkpoint);
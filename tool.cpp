@@ -0,0 +1,492 @@
+#include <Windows.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "print.h"
+#include "cricket.h"
+#include "dimensions.h"
+#include "heatmapFile.h"
+#include "parallel.h"
+#include "percentile.h"
+#include "query.h"
+#include "sampleBank.h"
+#include "scoreField.h"
+#include "sweep.h"
+
+
+/*
+
+    dartsTool bank <file> <generator> <count> [seed]        build a sample bank
+    dartsTool info <file>                                   describe a sample bank
+    dartsTool sweep <table> [bank]                          find the best aim over a grid of gaussian scatter models
+    dartsTool aim <table> <sigmaX> <sigmaY> <rho> [biasX biasY]     recommend an aim-point,  millimetres
+    dartsTool serve <socket> [table] [bank]                 answer aim queries on a local socket
+    dartsTool load <socket> [connections] [requests] [pipeline]     load-test a server
+    dartsTool cricket <policy> <sigmaX> <sigmaY> <rho> [biasX biasY]        solve cricket for a scatter model
+    dartsTool cricketAim <policy> <m15> <m16> <m17> <m18> <m19> <m20> <mBull>   where to aim,  given the marks so far
+    dartsTool heatmap <file> [samplesPerMm] [sigma]         write an expected-score heatmap,  then benchmark reading it
+
+*/
+
+
+namespace
+{
+
+constexpr std::string_view  generatorNames[]{"uniformDisc","circle","lowerCircle","realistic","gaussian"};
+
+static_assert(std::size(generatorNames) == Darts::generators);
+
+constexpr SweepGrid         defaultGrid
+{
+    {  5.0f, 60.0f, 12},        // sigmaX mm
+    {  5.0f, 60.0f, 12},        // sigmaY mm
+    { -0.6f,  0.6f,  7},        // rho
+};
+
+constexpr std::size_t       sweepDarts      {4096};
+constexpr std::uint64_t     sweepSeed       {1};
+constexpr int               sweepResolution {4};         // score field cells per mm
+
+constexpr std::size_t       heatmapDarts    {1024};
+constexpr int               heatmapReads    {10'000};
+constexpr std::uint32_t     heatmapRegion   {32};        // samples square,  around a random point
+
+
+Darts::Generator parseGenerator(std::string_view name)
+{
+    for(std::size_t i=0;i<std::size(generatorNames);i++)
+    {
+        if(name == generatorNames[i])
+        {
+            return static_cast<Darts::Generator>(i);
+        }
+    }
+
+    throw std::invalid_argument{"unknown generator " + std::string{name}};
+}
+
+
+void usage()
+{
+    print("usage : dartsTool bank <file> <generator> <count> [seed]\n"
+          "        dartsTool info <file>\n"
+          "        dartsTool sweep <table> [bank]\n"
+          "        dartsTool aim <table> <sigmaX> <sigmaY> <rho> [biasX biasY]\n"
+          "        dartsTool serve <socket> [table] [bank]\n"
+          "        dartsTool load <socket> [connections] [requests] [pipeline]\n"
+          "        dartsTool cricket <policy> <sigmaX> <sigmaY> <rho> [biasX biasY]\n"
+          "        dartsTool cricketAim <policy> <m15> <m16> <m17> <m18> <m19> <m20> <mBull>     marks 0-3\n"
+          "        dartsTool heatmap <file> [samplesPerMm] [sigma]\n"
+          "\n"
+          "generators : uniformDisc circle lowerCircle realistic gaussian\n");
+}
+
+
+void bankCommand(std::vector<std::string_view> const &args)
+{
+    if(args.size() < 3)
+    {
+        usage();
+        return;
+    }
+
+    auto const generator = parseGenerator(args[1]);
+    auto const count     = std::stoull(std::string{args[2]});
+    auto const seed      = args.size() > 3 ? std::stoull(std::string{args[3]},nullptr,0)
+                                           : (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+
+    auto const start = std::chrono::steady_clock::now();
+
+    Darts::SampleBank   bank{generator, seed, count};
+
+    std::chrono::duration<double> const elapsed{ std::chrono::steady_clock::now() - start};
+
+    bank.save(std::string{args[0]});
+
+    print("{} : {} darts, seed {:#x}, {:.3f}s ({:.1f} M darts/s)\n",
+          args[0], count, seed, elapsed.count(), count / elapsed.count() / 1e6);
+}
+
+
+void infoCommand(std::vector<std::string_view> const &args)
+{
+    if(args.empty())
+    {
+        usage();
+        return;
+    }
+
+    auto const  bank   = Darts::SampleBank::load(std::string{args[0]});         // rejects a generator without a name
+    auto const &header = bank.header();
+
+    print("{} : version {}, generator {}, seed {:#x}, {} darts, hash {:#018x}\n",
+          args[0], header.version, generatorNames[static_cast<std::size_t>(header.generator)],
+          header.seed, header.count, header.hash);
+}
+
+
+
+void sweepCommand(std::vector<std::string_view> const &args)
+{
+    if(args.empty())
+    {
+        usage();
+        return;
+    }
+
+    std::filesystem::path const table{args[0]};
+    auto                        checkpoint = table;
+
+    checkpoint += ".partial";
+
+    auto const normals = args.size() > 1 ? Darts::SampleBank::load(std::string{args[1]})
+                                         : Darts::SampleBank{Darts::Generator::gaussian, sweepSeed, sweepDarts};
+
+    if(normals.header().generator != Darts::Generator::gaussian)
+    {
+        throw std::invalid_argument{"sweep needs a gaussian sample bank"};
+    }
+
+    auto aims = std::filesystem::exists(checkpoint) ? AimTable::load(checkpoint)
+                                                    : AimTable{defaultGrid};
+
+    ScoreField const    field{sweepResolution};
+
+    sweep(aims, field, normals.view(), checkpoint);
+
+    aims.save(table);
+    std::filesystem::remove(checkpoint);
+}
+
+
+void aimCommand(std::vector<std::string_view> const &args)
+{
+    if(args.size() < 4)
+    {
+        usage();
+        return;
+    }
+
+    auto number = [&](std::size_t i)
+    {
+        return i < args.size() ? std::stof(std::string{args[i]}) : 0.0f;
+    };
+
+    auto const          aims = AimTable::load(std::string{args[0]});
+    ScatterModel const  player{ number(1), number(2), number(3), number(4), number(5)};
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const aim   = aims.recommend(player);
+
+    std::chrono::duration<double,std::micro> const elapsed{ std::chrono::steady_clock::now() - start};
+
+    print("aim at ({:.1f},{:.1f}) mm,  expected score {:.2f}   ({:.2f}us)\n", aim.x, aim.y, aim.expected, elapsed.count());
+}
+
+
+
+void serveCommand(std::vector<std::string_view> const &args)
+{
+    if(args.empty())
+    {
+        usage();
+        return;
+    }
+
+    Query::ServerOptions    options{std::string{args[0]}, {}, {}};
+
+    if(args.size() > 1)
+    {
+        options.aimTable = std::string{args[1]};
+    }
+
+    if(args.size() > 2)
+    {
+        options.bank = std::string{args[2]};
+    }
+
+    Query::serve(options);
+}
+
+
+void loadCommand(std::vector<std::string_view> const &args)
+{
+    if(args.empty())
+    {
+        usage();
+        return;
+    }
+
+    auto number = [&](std::size_t i, int otherwise)
+    {
+        return i < args.size() ? std::stoi(std::string{args[i]}) : otherwise;
+    };
+
+    Query::load({std::string{args[0]}, number(1,8), number(2,100'000), number(3,32)});
+}
+
+
+
+
+void cricketCommand(std::vector<std::string_view> const &args)
+{
+    if(args.size() < 4)
+    {
+        usage();
+        return;
+    }
+
+    auto number = [&](std::size_t i)
+    {
+        return i < args.size() ? std::stof(std::string{args[i]}) : 0.0f;
+    };
+
+    ScatterModel const  player{ number(1), number(2), number(3), number(4), number(5)};
+    ScoreField const    field{sweepResolution};
+    Darts::SampleBank   normals{Darts::Generator::gaussian, sweepSeed, sweepDarts};
+
+    auto const start  = std::chrono::steady_clock::now();
+    auto const policy = Cricket::solve(field, normals.view(), player);
+
+    std::chrono::duration<double> const elapsed{ std::chrono::steady_clock::now() - start};
+
+    policy.save(std::string{args[0]});
+
+    auto const opening = policy.aim({});
+
+    print("{} : {} states, {:.1f}s.  From the start aim at ({:.1f},{:.1f}) mm,  {:.1f} darts to close\n",
+          args[0], Cricket::states, elapsed.count(), opening.x, opening.y, opening.darts);
+}
+
+
+void cricketAimCommand(std::vector<std::string_view> const &args)
+{
+    if(args.size() < 1 + Cricket::targets)
+    {
+        usage();
+        return;
+    }
+
+    Cricket::Marks  marks{};
+
+    for(int target=0;target<Cricket::targets;target++)
+    {
+        auto const mark = std::stoi(std::string{args[1+target]});
+
+        if(mark < 0 || mark > Cricket::closed)
+        {
+            usage();
+            return;
+        }
+
+        marks[target] = static_cast<std::uint8_t>(mark);
+    }
+
+    auto const policy = Cricket::Policy::load(std::string{args[0]});
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const aim   = policy.aim(marks);
+
+    std::chrono::duration<double,std::micro> const elapsed{ std::chrono::steady_clock::now() - start};
+
+    print("aim at ({:.1f},{:.1f}) mm,  {:.1f} darts to close   ({:.2f}us)\n", aim.x, aim.y, aim.darts, elapsed.count());
+}
+
+
+
+
+void heatmapCommand(std::vector<std::string_view> const &args)
+{
+    if(args.empty())
+    {
+        usage();
+        return;
+    }
+
+    auto const samplesPerMm = args.size() > 1 ? std::stof(std::string{args[1]}) : 2.0f;
+    auto const sigma        = args.size() > 2 ? std::stof(std::string{args[2]}) : 15.0f;
+
+    auto const limit = static_cast<float>(Board::Radius::board);
+    auto const side  = static_cast<std::uint32_t>(2 * limit * samplesPerMm) + 1;
+
+    ScoreField const    field{sweepResolution};
+    Darts::SampleBank   normals{Darts::Generator::gaussian, sweepSeed, heatmapDarts};
+
+    auto const darts = scatter(normals.view(), {sigma, sigma, 0, 0, 0});
+
+    std::vector<float>  map(static_cast<std::size_t>(side) * side);            // kept,  to measure the quantisation error
+    std::atomic<std::uint32_t>  next{};
+
+    auto worker = [&]
+    {
+        for(auto row = next++; row < side; row = next++)
+        {
+            auto const y = row / samplesPerMm - limit;
+
+            for(std::uint32_t column=0;column<side;column++)
+            {
+                auto const x = column / samplesPerMm - limit;
+                int        total{};
+
+                for(std::size_t i=0;i<darts.x.size();i++)
+                {
+                    total += field.score(x + darts.x[i], y + darts.y[i]);
+                }
+
+                map[static_cast<std::size_t>(row) * side + column] = static_cast<float>(total) / darts.x.size();
+            }
+        }
+    };
+
+    runOnAllCores(worker);
+
+
+    auto start = std::chrono::steady_clock::now();
+
+    HeatmapFile::Writer     writer{std::string{args[0]}, side, side};
+
+    for(std::uint32_t row=0;row<side;row++)
+    {
+        writer.appendRow({map.data() + static_cast<std::size_t>(row) * side, side});
+    }
+
+    writer.finish();
+
+    std::chrono::duration<double> const writing{ std::chrono::steady_clock::now() - start};
+
+    auto const asDouble = static_cast<double>(map.size()) * sizeof(double);
+
+    print("{} : {}x{} samples,  {} bytes,  {:.1f}x smaller than float64,  written in {:.3f}s\n",
+          args[0], side, side, writer.bytesWritten(), asDouble / writer.bytesWritten(), writing.count());
+
+
+    auto const reader = HeatmapFile::Reader::open(std::string{args[0]});
+
+    std::vector<float>  decoded(map.size());
+
+    start = std::chrono::steady_clock::now();
+
+    reader.region(0, 0, side, side, decoded);
+
+    std::chrono::duration<double> const whole{ std::chrono::steady_clock::now() - start};
+
+    float worst{};
+
+    for(std::size_t i=0;i<map.size();i++)
+    {
+        worst = (std::max)(worst, std::abs(decoded[i] - map[i]));
+    }
+
+    print("whole map decoded in {:.3f}s,  largest quantisation error {:.2g}\n", whole.count(), worst);
+
+
+    auto const  size = (std::min)(heatmapRegion, side);
+    std::mt19937                                    random{sweepSeed};
+    std::uniform_int_distribution<std::uint32_t>    corner{0, side - size};
+    std::vector<float>                              region(static_cast<std::size_t>(size) * size);
+    std::vector<double>                             latencies;
+
+    for(int i=0;i<heatmapReads;i++)
+    {
+        auto const x = corner(random);
+        auto const y = corner(random);
+
+        start = std::chrono::steady_clock::now();
+
+        reader.region(x, y, size, size, region);
+
+        latencies.push_back(std::chrono::duration<double,std::micro>{std::chrono::steady_clock::now() - start}.count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    auto const &header = reader.header();
+    auto const  bestX  = std::clamp<std::uint32_t>(header.bestX, size/2, side - size + size/2) - size/2;
+    auto const  bestY  = std::clamp<std::uint32_t>(header.bestY, size/2, side - size + size/2) - size/2;
+
+    reader.region(bestX, bestY, size, size, region);
+
+    print("{} random {}x{} reads : p50 {:.1f}us  p90 {:.1f}us  p99 {:.1f}us\n",
+          heatmapReads, size, size, percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99));
+
+    print("best {:.2f} at ({:.1f},{:.1f}) mm,  {:.2f} after quantisation\n",
+          header.bestValue, header.bestX / samplesPerMm - limit, header.bestY / samplesPerMm - limit,
+          region[(header.bestY - bestY) * size + (header.bestX - bestX)]);
+}
+
+}
+
+
+int main(int argc, char *argv[])
+try
+{
+    std::vector<std::string_view>   args(argv+1, argv+argc);
+
+    if(args.empty())
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    auto const command = args.front();
+
+    args.erase(args.begin());
+
+    if(command == "bank")
+    {
+        bankCommand(args);
+    }
+    else if(command == "info")
+    {
+        infoCommand(args);
+    }
+    else if(command == "sweep")
+    {
+        sweepCommand(args);
+    }
+    else if(command == "aim")
+    {
+        aimCommand(args);
+    }
+    else if(command == "serve")
+    {
+        serveCommand(args);
+    }
+    else if(command == "load")
+    {
+        loadCommand(args);
+    }
+    else if(command == "cricket")
+    {
+        cricketCommand(args);
+    }
+    else if(command == "cricketAim")
+    {
+        cricketAimCommand(args);
+    }
+    else if(command == "heatmap")
+    {
+        heatmapCommand(args);
+    }
+    else
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch(std::exception const &e)
+{
+    print("error : {}\n", e.what());
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <numeric>
+
+#include "window.h"
+#include "traversal.h"
+
+
+namespace
+{
+
+constexpr int   coordinateBias{1 << 15};        // makes board coordinates positive before they're tiled
+
+
+std::uint32_t spread(std::uint32_t v)           // 16 bits out to the even bits
+{
+    v &= 0x0000ffff;
+    v  = (v | (v << 8)) & 0x00ff00ff;
+    v  = (v | (v << 4)) & 0x0f0f0f0f;
+    v  = (v | (v << 2)) & 0x33333333;
+    v  = (v | (v << 1)) & 0x55555555;
+
+    return v;
+}
+
+
+std::uint32_t morton(Traversal::AimPoint const &aim)
+{
+    auto const column = static_cast<std::uint32_t>(aim.x + coordinateBias) / Traversal::tilePixels;
+    auto const row    = static_cast<std::uint32_t>(aim.y + coordinateBias) / Traversal::tilePixels;
+
+    return spread(column) | (spread(row) << 1);
+}
+
+}
+
+
+namespace Traversal
+{
+
+BedRaster::BedRaster(BoardDimensions const &board)
+{
+    centre = board.radius.outerDouble + 1;
+    side   = 2 * centre + 1;
+
+    cells.resize(static_cast<std::size_t>(side) * side);
+
+    for(int y=0;y<side;y++)
+    {
+        for(int x=0;x<side;x++)
+        {
+            cells[y * side + x] = static_cast<std::int8_t>(Bed::index(scoreFromPoint(board, x-centre, y-centre)));
+        }
+    }
+}
+
+
+
+void evaluate(BedRaster const &raster, Darts::BankView const &darts, int radius,
+              std::span<AimPoint const> aims, std::span<Outcome> outcomes,
+              Order order, Hooks const &hooks, Counters &counters)
+{
+    counters = {};
+
+    std::vector<float>  offsetX(darts.size());                  // as outcomeAt computes them
+    std::vector<float>  offsetY(darts.size());
+
+    for(std::size_t i=0;i<darts.size();i++)
+    {
+        offsetX[i] = radius * darts.x[i];
+        offsetY[i] = radius * darts.y[i];
+    }
+
+
+    std::vector<std::size_t>    visit(aims.size());
+
+    std::iota(visit.begin(), visit.end(), std::size_t{});
+
+    if(order == Order::naive)
+    {
+        std::sort(visit.begin(), visit.end(), [&](auto a, auto b)
+        {
+            return aims[a].x != aims[b].x ? aims[a].x < aims[b].x : aims[a].y < aims[b].y;
+        });
+    }
+    else
+    {
+        std::sort(visit.begin(), visit.end(), [&](auto a, auto b)
+        {
+            auto const keyA = morton(aims[a]);
+            auto const keyB = morton(aims[b]);
+
+            if(keyA != keyB)
+            {
+                return keyA < keyB;
+            }
+
+            return aims[a].y != aims[b].y ? aims[a].y < aims[b].y : aims[a].x < aims[b].x;
+        });
+    }
+
+
+    auto const block = order == Order::naive ? (std::max)(darts.size(), std::size_t{1}) : dartBlock;
+
+    std::size_t tile{};
+
+    for(std::size_t first=0; first < visit.size(); tile++)      // a naive tile is a single aim-point
+    {
+        auto last = first + 1;
+
+        if(order == Order::morton)
+        {
+            auto const key = morton(aims[visit[first]]);
+
+            while(last < visit.size() && morton(aims[visit[last]]) == key)
+            {
+                last++;
+            }
+        }
+
+        for(auto v=first; v<last; v++)
+        {
+            outcomes[visit[v]] = Outcome{};
+            outcomes[visit[v]].darts = static_cast<std::uint32_t>(darts.size());
+        }
+
+        if(hooks.onTileBegin)
+        {
+            hooks.onTileBegin(tile);
+        }
+
+        for(std::size_t firstDart=0; firstDart < darts.size(); firstDart += block)
+        {
+            auto const lastDart = (std::min)(firstDart + block, darts.size());
+
+            if(hooks.onBlock)
+            {
+                hooks.onBlock(tile, firstDart, lastDart - firstDart);
+            }
+
+            for(auto v=first; v<last; v++)
+            {
+                auto const  x      = static_cast<float>(aims[visit[v]].x);
+                auto const  y      = static_cast<float>(aims[visit[v]].y);
+                auto       &counts = outcomes[visit[v]].counts;
+
+                for(auto i=firstDart; i<lastDart; i++)
+                {
+                    auto const bed = raster.bed(static_cast<int>(x + offsetX[i]), static_cast<int>(y + offsetY[i]));
+
+                    if(bed >= 0)
+                    {
+                        counts[bed]++;
+                    }
+                }
+            }
+
+            counters.blocks++;
+            counters.lookups += (last - first) * (lastDart - firstDart);
+        }
+
+        if(hooks.onTileEnd)
+        {
+            hooks.onTileEnd(tile);
+        }
+
+        counters.tiles++;
+        first = last;
+    }
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "dimensions.h"
+#include "outcome.h"
+#include "sampleBank.h"
+
+
+/*
+
+    Evaluates the outcomes of many aim-points at once.
+
+    The darts of the sample bank land within reach of their aim-point,  so
+    neighbouring aim-points look up the same part of the board.  The morton
+    order groups the aim-points into tilePixels square tiles,  visited along a
+    Z curve,  and throws the bank a block at a time at every aim-point of a
+    tile.  The tile's counts and the part of the bed raster the block touches
+    then stay in cache,  rather than each aim-point streaming the whole bank
+    over the whole board.
+
+    Every dart is thrown exactly as outcomeAt throws it and the counts are
+    integers,  so the outcomes are identical whichever order is used.
+
+*/
+
+
+namespace Traversal
+{
+
+constexpr int           tilePixels{8};          // aim-points closer than this share a tile
+constexpr std::size_t   dartBlock{256};         // darts thrown at a tile at a time
+
+
+enum class Order
+{
+    naive,                  // x then y,  every dart at one aim-point before the next
+    morton,                 // tiles along a Z curve,  darts in blocks
+};
+
+
+struct AimPoint             // board coordinates
+{
+    int x;
+    int y;
+};
+
+
+
+class BedRaster             // Bed::index of every pixel on the board,  from scoreFromPoint
+{
+public:
+
+    explicit BedRaster(BoardDimensions const &board);
+
+    int bed(int x, int y) const                 // board coordinates,  -1 for a miss
+    {
+        x += centre;
+        y += centre;
+
+        if(   static_cast<unsigned>(x) >= static_cast<unsigned>(side)
+           || static_cast<unsigned>(y) >= static_cast<unsigned>(side))
+        {
+            return -1;
+        }
+
+        return cells[y * side + x];
+    }
+
+private:
+
+    int                         centre;
+    int                         side;
+    std::vector<std::int8_t>    cells;          // row major
+};
+
+
+
+struct Counters             // of one evaluate call,  so a run can be divided by tiles, blocks or lookups when reading hardware counters
+{
+    std::uint64_t   tiles;
+    std::uint64_t   blocks;
+    std::uint64_t   lookups;
+};
+
+
+struct Hooks                // called on the evaluating thread,  to bracket regions with hardware counter reads.  Any may be empty
+{
+    std::function<void(std::size_t tile)>                                           onTileBegin;
+    std::function<void(std::size_t tile)>                                           onTileEnd;
+    std::function<void(std::size_t tile, std::size_t firstDart, std::size_t darts)> onBlock;
+};
+
+
+void evaluate(BedRaster const &raster, Darts::BankView const &darts, int radius,
+              std::span<AimPoint const> aims, std::span<Outcome> outcomes,
+              Order order, Hooks const &hooks, Counters &counters);
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Windows.h>
+
+#include <system_error>
+
+
+[[noreturn]] inline void throwLastError(char const *what)
+{
+    throw std::system_error{ static_cast<int>(GetLastError()), std::system_category(), what};
+}
+
+
+struct Handle                   // closes a kernel handle,  either failure value is allowed
+{
+    HANDLE  h;
+
+    Handle(HANDLE h) : h{h}
+    {
+    }
+
+    Handle(Handle const &)            = delete;
+    Handle &operator=(Handle const &) = delete;
+
+    ~Handle()
+    {
+        if(h != nullptr && h != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(h);
+        }
+    }
+};
@@ -7,16 +7,24 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <system_error>
 #include <numbers>
 #include <tuple>
 #include <thread>
+#include <mutex>
+#include <cstdlib>
 
 #include "print.h"
 #include "window.h"
 #include "resource.h"
 
 #include "dimensions.h"
+#include "heatmap.h"
+#include "optimizer.h"
+#include "outcome.h"
+#include "sampleBank.h"
+#include "traversal.h"
 
 
 
@@ -24,11 +32,26 @@ HWND                theWindow   {};
 HWND                theDialog   {};
 
 constexpr int       WM_REFRESH  {WM_APP};
+constexpr UINT_PTR  objectiveTimer{1};
+constexpr UINT      objectiveDelay{400};    // ms after the last keystroke in the parameter,  before rescoring
 constexpr auto      windowStyle { WS_OVERLAPPEDWINDOW | WS_VISIBLE    };
 
 POINT               mousePosition{};
 int                 accuracy{};             
 POINT               bestPoint{};
+bool                bestApproximate{};
+
+std::mutex          objectiveLock;          // the UI thread changes the objective while findBest runs
+ObjectiveSpec       objective{Objective::mean};
+
+
+ObjectiveSpec currentObjective()
+{
+    std::lock_guard guard{objectiveLock};
+
+    return objective;
+}
+
 
 void mouseMoveAim(BoardDimensions const &board,int x, int y)     // board coordinates
 {
@@ -58,32 +81,39 @@ void mouseMoveAim(BoardDimensions const &board,int x, int y)     // board coordi
 }
 
 
-auto expectedScore(BoardDimensions const &board,int x, int y)
+Outcome outcomeAt(BoardDimensions const &board,float x, float y)
 {
-    double expectedScore{};
+    Outcome outcome{};
 
     auto radius = static_cast<int>(board.radius.outerTriple * (accuracy / 100.0));
 
-    for(auto const &dart : Darts::darts)
+    auto const darts  = Darts::bank.view();
+
+    for(std::size_t i=0;i<darts.size();i++)
     {
-        auto dx = static_cast<int>(x + radius * dart.X);
-        auto dy = static_cast<int>(y + radius * dart.Y);
+        auto dx = static_cast<int>(x + radius * darts.x[i]);
+        auto dy = static_cast<int>(y + radius * darts.y[i]);
 
-        auto [score, multiplier] = scoreFromPoint(board,dx,dy);
+        auto bed = Bed::index(scoreFromPoint(board,dx,dy));
 
-        expectedScore+=score*multiplier;
+        if(bed >= 0)
+        {
+            outcome.counts[bed]++;
+        }
     }
 
-    return expectedScore / Darts::numDarts;
+    outcome.darts = static_cast<std::uint32_t>(darts.size());
+
+    return outcome;
 }
 
 
 void mouseMoveDarts(BoardDimensions const &board,int x, int y)     // board coordinates
 {
 
-    auto  expectedScore = ::expectedScore(board,x,y);
+    auto  summary = summarise(outcomeAt(board,x,y), currentObjective());
 
-    auto text = std::format("{:2.1f}",expectedScore);
+    auto text = std::format("{:2.1f}  +/-{:2.1f}",summary.mean, std::sqrt(summary.variance));
 
     SetDlgItemText(theDialog, IDC_EXPECTED_SCORE, text.c_str());
 }
@@ -104,42 +134,181 @@ void mouseMove(HWND h, int x, int y)
 
 }
 
+std::vector<Point2> optimizerStarts(BoardDimensions const &board)      // the bull and the middle of every treble,  client coordinates
+{
+    std::vector<Point2> starts{ {static_cast<float>(board.center.X), static_cast<float>(board.center.Y)}};
+
+    for(int sector=0;sector<20;sector++)
+    {
+        auto const from = radiusDimensions(board, sector);
+        auto const to   = radiusDimensions(board, sector+1);
+
+        starts.push_back({ (from.innerTriple.X + from.outerTriple.X + to.innerTriple.X + to.outerTriple.X) / 4.0f,
+                           (from.innerTriple.Y + from.outerTriple.Y + to.innerTriple.Y + to.outerTriple.Y) / 4.0f});
+    }
+
+    return starts;
+}
+
+
+void findBestOptimized()
+{
+    auto board { boardDimensions(theWindow)};
+
+    auto const spec = currentObjective();       // fixed for the whole run,  the simplex can't follow a moving function
+
+    auto evaluate = [&](float x, float y)
+    {
+        return summarise(outcomeAt(board, x - board.center.X, y - board.center.Y), spec).value;
+    };
+
+    auto const treble = static_cast<float>(board.radius.outerTriple - board.radius.innerTriple);
+    auto const spread = static_cast<float>(board.radius.outerTriple * (accuracy / 100.0));
+    auto const step   = (std::max)(treble, spread / 2);                 // the simplex must straddle the plateaus a wide spread makes
+    auto const result = multiStart(evaluate, optimizerStarts(board), step, 0.25f);
+
+    for(auto const &run : result.runs)
+    {
+        print("optimize from ({:5.1f},{:5.1f}) to ({:5.1f},{:5.1f}) {:5.2f} in {:3} evaluations{}\n",
+              run.start[0], run.start[1], run.best[0], run.best[1], run.value, run.evaluations, run.converged ? "" : " (not converged)");
+    }
+
+    print("findBest optimized evaluated {:6} best {:2.1f}\n", result.evaluations, result.value);
+
+    bestPoint       = POINT{std::lround(result.best[0]), std::lround(result.best[1])};
+    bestApproximate = false;
+    PostMessage(theWindow,WM_REFRESH,0,0);
+}
+
+
 void findBest()
 {
+    if(IsDlgButtonChecked(theDialog, IDC_OPTIMIZE) == BST_CHECKED)
+    {
+        findBestOptimized();
+        return;
+    }
+
     RECT client{};
     GetClientRect(theWindow,&client);
 
     auto board { boardDimensions(theWindow)};
 
-    double bestScore{};
+    Traversal::BedRaster const  raster{board};
+    Traversal::Counters         counters{};
+    LARGE_INTEGER               frequency{};
+    LARGE_INTEGER               tileStart{};
+    LONGLONG                    tileTicks{};            // of the last evaluate call
+    LONGLONG                    slowestTile{};
+    bool                        checked{};
 
-    for(int x=client.left; x<client.right;x++)
+    QueryPerformanceFrequency(&frequency);
+
+    Traversal::Hooks const      hooks
     {
-        print("findBest {} {:2.1f}   \r",x,bestScore);
+        [&](std::size_t)
+        {
+            QueryPerformanceCounter(&tileStart);
+        },
+        [&](std::size_t)
+        {
+            LARGE_INTEGER   now{};
+            QueryPerformanceCounter(&now);
 
-        for(int y=client.top; y<client.bottom;y++)
+            tileTicks  += now.QuadPart - tileStart.QuadPart;
+            slowestTile = (std::max)(slowestTile, now.QuadPart - tileStart.QuadPart);
+        },
+        {}
+    };
+
+    auto evaluate = [&](std::span<HeatmapSample const> samples, std::span<Outcome> outcomes)
+    {
+        std::vector<Traversal::AimPoint>    aims;
+
+        for(auto const &sample : samples)
         {
-            int const hitx = x - board.center.X;
-            int const hity = y - board.center.Y;
+            aims.push_back({sample.x - board.center.X, sample.y - board.center.Y});
+        }
 
-            double score = ::expectedScore(board,hitx,hity);
+        auto const radius = static_cast<int>(board.radius.outerTriple * (accuracy / 100.0));
 
-            if(score > bestScore)
-            {
-                bestScore=score;
-                bestPoint = POINT{x,y};
-                PostMessage(theWindow,WM_REFRESH,0,0);
-            }
+        tileTicks   = 0;
+        slowestTile = 0;
+
+        Traversal::evaluate(raster, Darts::bank.view(), radius, aims, outcomes, Traversal::Order::morton, hooks, counters);
+
+#ifndef NDEBUG
+        if(!checked)                            // the coarsest level :  the orders must agree to the last count
+        {
+            std::vector<Outcome>    naive(outcomes.size());
+            Traversal::Counters     naiveCounters{};
+
+            Traversal::evaluate(raster, Darts::bank.view(), radius, aims, naive, Traversal::Order::naive, {}, naiveCounters);
+
+            assert(std::memcmp(naive.data(), outcomes.data(), outcomes.size_bytes()) == 0);
         }
-    }
+#endif
+        checked = true;
+    };
 
+    auto const spec = currentObjective();       // the pyramid is pruned for this one,  whatever the UI does meanwhile
 
-    print("findBest done {:2.1f}    \n",bestScore);
+    auto publish = [&](std::shared_ptr<HeatmapPyramid const> pyramid)
+    {
+        std::lock_guard guard{objectiveLock};
 
+        if(pyramid->spec != objective)          // changed since the build started,  so don't undo changeObjective
+        {
+            pyramid = rescoreHeatmap(*pyramid, objective);
+        }
 
+        auto const &level = *pyramid->levels.back();
 
+        auto const microseconds = [&](LONGLONG ticks){ return 1e6 * ticks / frequency.QuadPart; };
+
+        print("findBest step {:2} evaluated {:6} best {:2.1f}{}  tiles {:6} blocks {:7} lookups {:10}  tile {:6.1f}us mean {:7.1f}us max\n",
+              level.step, level.evaluated, pyramid->bestScore, pyramid->approximate() ? " (approximate)" : "",
+              counters.tiles, counters.blocks, counters.lookups,
+              counters.tiles ? microseconds(tileTicks) / counters.tiles : 0.0, microseconds(slowestTile));
+
+        bestPoint       = POINT{pyramid->bestX, pyramid->bestY};
+        bestApproximate = pyramid->approximate();
+        publishHeatmap(std::move(pyramid));
+        PostMessage(theWindow,WM_REFRESH,0,0);
+    };
+
+    buildHeatmap(client.right-client.left, client.bottom-client.top, static_cast<std::uint32_t>(Darts::bank.view().size()), spec, evaluate, publish);
+
+    print("findBest done\n");
 }
 
+void changeObjective(HWND h)       // rescores the heatmap,  doesn't re-evaluate it
+{
+    char text[32]{};
+    GetDlgItemText(h, IDC_OBJECTIVE_PARAM, text, sizeof(text));
+
+    auto const selection = static_cast<int>(SendDlgItemMessage(h,IDC_OBJECTIVE,CB_GETCURSEL,0,0));
+    auto const parameter = std::atof(text);
+
+    std::lock_guard guard{objectiveLock};
+
+    objective = { selection > 0 ? static_cast<Objective>(selection) : Objective::mean, parameter, parameter};
+
+    if(auto pyramid = publishedHeatmap())
+    {
+        auto rescored = rescoreHeatmap(*pyramid, objective);
+
+        print("rescored best {:2.1f}{}\n", rescored->bestScore, rescored->approximate() ? " (approximate,  find best again to be sure)" : "");
+
+        bestPoint       = POINT{rescored->bestX, rescored->bestY};
+        bestApproximate = rescored->approximate();
+        publishHeatmap(std::move(rescored));
+    }
+
+    PostMessage(theWindow,WM_REFRESH,0,0);
+}
+
+
 LRESULT CALLBACK windowProc(HWND h, UINT m, WPARAM w, LPARAM l)
 {
     switch(m)
@@ -196,6 +365,24 @@ INT_PTR CALLBACK dialogProc(HWND h, UINT m, WPARAM w, LPARAM l)
             std::thread{findBest}.detach();
             break;
 
+        case IDC_OBJECTIVE:
+            if(HIWORD(w) == CBN_SELCHANGE)
+            {
+                auto const selection = static_cast<Objective>(SendDlgItemMessage(h,IDC_OBJECTIVE,CB_GETCURSEL,0,0));
+
+                SetDlgItemText(h, IDC_OBJECTIVE_PARAM, selection == Objective::atLeast ? "60" : "1");      // threshold or lambda
+                KillTimer(h, objectiveTimer);                                                               // SetDlgItemText started it
+                changeObjective(h);
+            }
+            break;
+
+        case IDC_OBJECTIVE_PARAM:
+            if(HIWORD(w) == EN_CHANGE)
+            {
+                SetTimer(h, objectiveTimer, objectiveDelay, nullptr);       // restarts it,  so a number being typed is rescored once
+            }
+            break;
+
         case IDCANCEL:
             PostQuitMessage(0);
             EndDialog(h,0);
@@ -205,6 +392,11 @@ INT_PTR CALLBACK dialogProc(HWND h, UINT m, WPARAM w, LPARAM l)
 
     case WM_INITDIALOG:
         SendDlgItemMessage(h,IDC_SATURATION,TBM_SETPOS,TRUE,50);
+        SendDlgItemMessage(h,IDC_OBJECTIVE,CB_ADDSTRING,0,reinterpret_cast<LPARAM>("Expected score"));
+        SendDlgItemMessage(h,IDC_OBJECTIVE,CB_ADDSTRING,0,reinterpret_cast<LPARAM>("P(score >= t)"));
+        SendDlgItemMessage(h,IDC_OBJECTIVE,CB_ADDSTRING,0,reinterpret_cast<LPARAM>("Mean - lambda * sd"));
+        SendDlgItemMessage(h,IDC_OBJECTIVE,CB_SETCURSEL,0,0);
+        SetDlgItemText(h, IDC_OBJECTIVE_PARAM, "1");
         accuracy= 2 + static_cast<int>(SendDlgItemMessage(h,IDC_SATURATION,TBM_GETPOS,0,0));
         ShowWindow(h,SW_SHOW);
         return false;
@@ -216,10 +408,19 @@ INT_PTR CALLBACK dialogProc(HWND h, UINT m, WPARAM w, LPARAM l)
     case WM_CTLCOLORSTATIC:
         break;
 
+    case WM_TIMER:
+        if(w == objectiveTimer)
+        {
+            KillTimer(h, objectiveTimer);
+            changeObjective(h);
+        }
+        break;
+
     case WM_HSCROLL:
     {
         accuracy= 2 + static_cast<int>(SendDlgItemMessage(h,IDC_SATURATION,TBM_GETPOS,0,0));
 
+        publishHeatmap(nullptr);                    // it was for the old accuracy
         PostMessage(theWindow,WM_REFRESH,0,0);
         break;        
     }
@@ -301,6 +502,8 @@ void windowMessageLoop()
 
 int main()
 {
+    Darts::bank = Darts::openBank("darts.bank", Darts::Generator::realistic, 500);
+
     createWindow();
     createDialog();
     windowMessageLoop();
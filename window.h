@@ -23,3 +23,4 @@ DartHit scoreFromPoint(BoardDimensions const &board, int x,int y);     // board
 extern POINT                        mousePosition;   // client coordinates
 extern int                          accuracy;        // 2=high, 102 =low        
 extern POINT                        bestPoint;
+extern bool                         bestApproximate; // from a heatmap rescored for another objective